@@ -0,0 +1,1479 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <reflection-cpp/algorithm.hpp>
+#include <reflection-cpp/binary-chunks.hpp>
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/columnar.hpp>
+#include <reflection-cpp/deep-size.hpp>
+#include <reflection-cpp/deferred.hpp>
+#include <reflection-cpp/delta.hpp>
+#include <reflection-cpp/gather-writer.hpp>
+#include <reflection-cpp/generate.hpp>
+#include <reflection-cpp/indexed-vector.hpp>
+#include <reflection-cpp/msgpack.hpp>
+#include <reflection-cpp/reflection.hpp>
+#include <reflection-cpp/seq-locked.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Counting allocator: all global allocations of this process are counted, such that the allocations
+// a benchmarked operation performs can be reported next to its timing.
+
+namespace
+{
+
+std::atomic<size_t> allocationCount { 0 };
+std::atomic<size_t> allocationBytes { 0 };
+
+void* CountedAllocate(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+
+/// Runs f repeatedly and prints the average number of allocations and allocated bytes per call.
+template <typename F>
+void ReportAllocations(std::string_view name, F&& f)
+{
+    constexpr size_t Iterations = 1000;
+    auto const countBefore = allocationCount.load();
+    auto const bytesBefore = allocationBytes.load();
+    for (size_t i = 0; i < Iterations; ++i)
+        [[maybe_unused]] auto const result = f();
+    auto const count = allocationCount.load() - countBefore;
+    auto const bytes = allocationBytes.load() - bytesBefore;
+    std::cout << std::format("{:<48} {:8.2f} allocations/op {:10.1f} bytes/op\n",
+                             name,
+                             static_cast<double>(count) / Iterations,
+                             static_cast<double>(bytes) / Iterations)
+              << std::flush;
+}
+
+/// Registers a Catch2 benchmark and reports its allocations per call.
+#define REFLECTION_BENCHMARK(name, ...)      \
+    ReportAllocations(name, [&] __VA_ARGS__); \
+    BENCHMARK(name) __VA_ARGS__
+
+// ---------------------------------------------------------------------------
+// fixtures
+
+struct Narrow
+{
+    int id {};
+    double value {};
+    std::string name;
+};
+
+struct Wide
+{
+    std::int32_t a0 {};
+    std::int64_t a1 {};
+    double a2 {};
+    float a3 {};
+    std::uint32_t a4 {};
+    std::int16_t a5 {};
+    std::uint64_t a6 {};
+    double a7 {};
+    std::int32_t a8 {};
+    std::int64_t a9 {};
+    double a10 {};
+    float a11 {};
+    std::uint32_t a12 {};
+    std::int16_t a13 {};
+    std::uint64_t a14 {};
+    double a15 {};
+};
+
+// Wide with its members in reverse order, so that AssignByName has to map every member.
+struct WideReversed
+{
+    double a15 {};
+    std::uint64_t a14 {};
+    std::int16_t a13 {};
+    std::uint32_t a12 {};
+    float a11 {};
+    double a10 {};
+    std::int64_t a9 {};
+    std::int32_t a8 {};
+    double a7 {};
+    std::uint64_t a6 {};
+    std::int16_t a5 {};
+    std::uint32_t a4 {};
+    float a3 {};
+    double a2 {};
+    std::int64_t a1 {};
+    std::int32_t a0 {};
+};
+
+// Layout-identical twin of Wide, which AssignByName copies as a whole.
+struct WideCopy
+{
+    std::int32_t a0 {};
+    std::int64_t a1 {};
+    double a2 {};
+    float a3 {};
+    std::uint32_t a4 {};
+    std::int16_t a5 {};
+    std::uint64_t a6 {};
+    double a7 {};
+    std::int32_t a8 {};
+    std::int64_t a9 {};
+    double a10 {};
+    float a11 {};
+    std::uint32_t a12 {};
+    std::int16_t a13 {};
+    std::uint64_t a14 {};
+    double a15 {};
+};
+
+// 64 integral members without padding, which CollectDifferences compares as a byte block.
+struct Numeric64
+{
+    std::uint64_t a0 {};
+    std::uint64_t a1 {};
+    std::uint64_t a2 {};
+    std::uint64_t a3 {};
+    std::uint64_t a4 {};
+    std::uint64_t a5 {};
+    std::uint64_t a6 {};
+    std::uint64_t a7 {};
+    std::uint64_t a8 {};
+    std::uint64_t a9 {};
+    std::uint64_t a10 {};
+    std::uint64_t a11 {};
+    std::uint64_t a12 {};
+    std::uint64_t a13 {};
+    std::uint64_t a14 {};
+    std::uint64_t a15 {};
+    std::uint64_t a16 {};
+    std::uint64_t a17 {};
+    std::uint64_t a18 {};
+    std::uint64_t a19 {};
+    std::uint64_t a20 {};
+    std::uint64_t a21 {};
+    std::uint64_t a22 {};
+    std::uint64_t a23 {};
+    std::uint64_t a24 {};
+    std::uint64_t a25 {};
+    std::uint64_t a26 {};
+    std::uint64_t a27 {};
+    std::uint64_t a28 {};
+    std::uint64_t a29 {};
+    std::uint64_t a30 {};
+    std::uint64_t a31 {};
+    std::uint32_t b0 {};
+    std::uint32_t b1 {};
+    std::uint32_t b2 {};
+    std::uint32_t b3 {};
+    std::uint32_t b4 {};
+    std::uint32_t b5 {};
+    std::uint32_t b6 {};
+    std::uint32_t b7 {};
+    std::uint32_t b8 {};
+    std::uint32_t b9 {};
+    std::uint32_t b10 {};
+    std::uint32_t b11 {};
+    std::uint32_t b12 {};
+    std::uint32_t b13 {};
+    std::uint32_t b14 {};
+    std::uint32_t b15 {};
+    std::uint32_t b16 {};
+    std::uint32_t b17 {};
+    std::uint32_t b18 {};
+    std::uint32_t b19 {};
+    std::uint32_t b20 {};
+    std::uint32_t b21 {};
+    std::uint32_t b22 {};
+    std::uint32_t b23 {};
+    std::uint32_t b24 {};
+    std::uint32_t b25 {};
+    std::uint32_t b26 {};
+    std::uint32_t b27 {};
+    std::uint32_t b28 {};
+    std::uint32_t b29 {};
+    std::uint32_t b30 {};
+    std::uint32_t b31 {};
+};
+
+struct Nested
+{
+    Narrow head;
+    Narrow tail;
+    int count {};
+    std::string label;
+};
+
+Narrow MakeNarrow(int i)
+{
+    return Narrow { .id = i, .value = i * 0.5, .name = "narrow record " + std::to_string(i) };
+}
+
+Wide MakeWide(int i)
+{
+    auto const f = static_cast<float>(i);
+    return Wide { i, i + 1, i + 2.5, f + 3.5f, 4u, 5, 6u, 7.5, 8, 9, 10.5, 11.5f, 12u, 13, 14u, 15.5 };
+}
+
+Nested MakeNested(int i)
+{
+    return Nested { .head = MakeNarrow(i), .tail = MakeNarrow(i + 1), .count = i, .label = "nested" };
+}
+
+// Adds a member value to a running total, used as the common workload of visiting benchmarks.
+template <typename T>
+double Accumulate(double total, T const& value)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+        return total + static_cast<double>(value);
+    else if constexpr (std::is_convertible_v<T const&, std::string_view>)
+        return total + static_cast<double>(std::string_view(value).size());
+    else
+        return Reflection::FoldMembers(
+            value, total, [](auto&& /*name*/, auto&& member, double accum) { return Accumulate(accum, member); });
+}
+
+// clang-format off
+std::string HandInspect(Narrow const& r)
+{
+    return std::format("id={} value={} name=\"{}\"", r.id, r.value, r.name);
+}
+
+std::string HandInspect(Wide const& r)
+{
+    return std::format("a0={} a1={} a2={} a3={} a4={} a5={} a6={} a7={} a8={} a9={} a10={} a11={} a12={} a13={} "
+                       "a14={} a15={}",
+                       r.a0, r.a1, r.a2, r.a3, r.a4, r.a5, r.a6, r.a7, r.a8, r.a9, r.a10, r.a11, r.a12, r.a13,
+                       r.a14, r.a15);
+}
+
+std::string HandInspect(Nested const& r)
+{
+    return std::format("head={{{}}} tail={{{}}} count={} label=\"{}\"",
+                       HandInspect(r.head), HandInspect(r.tail), r.count, r.label);
+}
+
+double HandAccumulate(Narrow const& r)
+{
+    return r.id + r.value + static_cast<double>(r.name.size());
+}
+
+double HandAccumulate(Wide const& r)
+{
+    return static_cast<double>(r.a0 + r.a1) + r.a2 + r.a3 + r.a4 + r.a5 + static_cast<double>(r.a6) + r.a7 + r.a8
+           + static_cast<double>(r.a9) + r.a10 + r.a11 + r.a12 + r.a13 + static_cast<double>(r.a14) + r.a15;
+}
+
+double HandAccumulate(Nested const& r)
+{
+    return HandAccumulate(r.head) + HandAccumulate(r.tail) + r.count + static_cast<double>(r.label.size());
+}
+
+size_t HandDifferences(Narrow const& a, Narrow const& b)
+{
+    return size_t(a.id != b.id) + size_t(a.value != b.value) + size_t(a.name != b.name);
+}
+
+size_t HandDifferences(Wide const& a, Wide const& b)
+{
+    return size_t(a.a0 != b.a0) + size_t(a.a1 != b.a1) + size_t(a.a2 != b.a2) + size_t(a.a3 != b.a3)
+           + size_t(a.a4 != b.a4) + size_t(a.a5 != b.a5) + size_t(a.a6 != b.a6) + size_t(a.a7 != b.a7)
+           + size_t(a.a8 != b.a8) + size_t(a.a9 != b.a9) + size_t(a.a10 != b.a10) + size_t(a.a11 != b.a11)
+           + size_t(a.a12 != b.a12) + size_t(a.a13 != b.a13) + size_t(a.a14 != b.a14) + size_t(a.a15 != b.a15);
+}
+
+size_t HandDifferences(Nested const& a, Nested const& b)
+{
+    return HandDifferences(a.head, b.head) + HandDifferences(a.tail, b.tail) + size_t(a.count != b.count)
+           + size_t(a.label != b.label);
+}
+// clang-format on
+
+struct Address
+{
+    std::string street;
+    std::string city;
+    int zip {};
+};
+
+struct Customer
+{
+    std::uint64_t id {};
+    std::string name;
+    std::string email;
+    int age {};
+    double balance {};
+    bool active {};
+    Address address;
+    std::vector<std::string> tags;
+};
+
+// The same type as Customer, as seen by an older reader that does not know about some of the members.
+struct CustomerV1
+{
+    std::uint64_t id {};
+    std::string name;
+    int age {};
+    Address address;
+};
+
+std::vector<Customer> MakeCustomers(size_t count)
+{
+    auto rng = std::mt19937_64 { 42 };
+    return Reflection::Generate<Customer>(rng, count);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// public reflection operations versus hand-written equivalents
+
+TEMPLATE_TEST_CASE("Inspect", "[benchmark]", Narrow, Wide, Nested)
+{
+    auto const record = [] {
+        if constexpr (std::is_same_v<TestType, Narrow>)
+            return MakeNarrow(42);
+        else if constexpr (std::is_same_v<TestType, Wide>)
+            return MakeWide(42);
+        else
+            return MakeNested(42);
+    }();
+    REQUIRE(Reflection::Inspect(record) == HandInspect(record));
+
+    REFLECTION_BENCHMARK("Inspect", { return Reflection::Inspect(record); });
+    auto buffer = std::string {};
+    REFLECTION_BENCHMARK("InspectTo (reused buffer)", {
+        buffer.clear();
+        Reflection::InspectTo(buffer, record);
+        return buffer.size();
+    });
+    REFLECTION_BENCHMARK("Inspect<FixedCapacity<32>>",
+                         { return Reflection::Inspect<Reflection::FixedCapacity<32>>(record).size(); });
+    REFLECTION_BENCHMARK("hand-written", { return HandInspect(record); });
+}
+
+TEST_CASE("Inspect.vector", "[benchmark]")
+{
+    auto records = std::vector<Narrow> {};
+    for (int i = 0; i < 100; ++i)
+        records.push_back(MakeNarrow(i));
+
+    REFLECTION_BENCHMARK("Inspect(vector)", { return Reflection::Inspect(records); });
+    REFLECTION_BENCHMARK("hand-written", {
+        auto result = std::string {};
+        for (auto const& record: records)
+        {
+            result += HandInspect(record);
+            result += '\n';
+        }
+        return result;
+    });
+}
+
+struct Snapshot
+{
+    std::vector<Narrow> records;
+    std::map<std::string, double> totals;
+    std::vector<double> series;
+};
+
+TEST_CASE("Inspect.containers", "[benchmark]")
+{
+    auto snapshot = Snapshot {};
+    for (int i = 0; i < 1000; ++i)
+    {
+        snapshot.records.push_back(MakeNarrow(i));
+        snapshot.totals.emplace("account " + std::to_string(i), i * 1.5);
+        snapshot.series.push_back(i * 0.25);
+    }
+
+    REFLECTION_BENCHMARK("Inspect", { return Reflection::Inspect(snapshot); });
+    REFLECTION_BENCHMARK("hand-written, growing the string", {
+        auto result = std::string { "records=[" };
+        for (auto const& record: snapshot.records)
+            std::format_to(std::back_inserter(result), "{{{}}}, ", HandInspect(record));
+        result += "] totals={";
+        for (auto const& [name, total]: snapshot.totals)
+            std::format_to(std::back_inserter(result), "\"{}\": {}, ", name, total);
+        result += "} series=[";
+        for (auto const value: snapshot.series)
+            std::format_to(std::back_inserter(result), "{}, ", value);
+        result += ']';
+        return result;
+    });
+}
+
+TEMPLATE_TEST_CASE("CallOnMembers", "[benchmark]", Narrow, Wide, Nested)
+{
+    auto const record = [] {
+        if constexpr (std::is_same_v<TestType, Narrow>)
+            return MakeNarrow(42);
+        else if constexpr (std::is_same_v<TestType, Wide>)
+            return MakeWide(42);
+        else
+            return MakeNested(42);
+    }();
+
+    REFLECTION_BENCHMARK("CallOnMembers", {
+        double total = 0;
+        Reflection::CallOnMembers(record, [&](auto&& /*name*/, auto&& value) { total = Accumulate(total, value); });
+        return total;
+    });
+    REFLECTION_BENCHMARK("CallOnMembersWithoutName", {
+        double total = 0;
+        Reflection::CallOnMembersWithoutName(
+            record, [&]<size_t I, typename T>(T const& value) { total = Accumulate(total, value); });
+        return total;
+    });
+    REFLECTION_BENCHMARK("hand-written", { return HandAccumulate(record); });
+}
+
+TEMPLATE_TEST_CASE("FoldMembers", "[benchmark]", Narrow, Wide, Nested)
+{
+    auto const record = [] {
+        if constexpr (std::is_same_v<TestType, Narrow>)
+            return MakeNarrow(42);
+        else if constexpr (std::is_same_v<TestType, Wide>)
+            return MakeWide(42);
+        else
+            return MakeNested(42);
+    }();
+    REQUIRE(Accumulate(0.0, record) == HandAccumulate(record));
+
+    REFLECTION_BENCHMARK("FoldMembers", { return Accumulate(0.0, record); });
+    REFLECTION_BENCHMARK("hand-written", { return HandAccumulate(record); });
+}
+
+TEMPLATE_TEST_CASE("CollectDifferences", "[benchmark]", Narrow, Wide, Nested)
+{
+    auto const [lhs, rhs] = [] {
+        if constexpr (std::is_same_v<TestType, Narrow>)
+            return std::pair { MakeNarrow(1), MakeNarrow(2) };
+        else if constexpr (std::is_same_v<TestType, Wide>)
+            return std::pair { MakeWide(1), MakeWide(2) };
+        else
+            return std::pair { MakeNested(1), MakeNested(2) };
+    }();
+
+    REFLECTION_BENCHMARK("CollectDifferences", {
+        size_t count = 0;
+        Reflection::CollectDifferences(
+            lhs, rhs, [&](std::string_view /*name*/, auto const& /*a*/, auto const& /*b*/) { ++count; });
+        return count;
+    });
+    REFLECTION_BENCHMARK("hand-written", { return HandDifferences(lhs, rhs); });
+}
+
+// The member-wise comparison CollectDifferences falls back to for types it cannot compare as a byte block.
+template <typename T>
+size_t MemberwiseDifferences(T const& lhs, T const& rhs)
+{
+    size_t count = 0;
+    Reflection::template_for<0, Reflection::CountMembers<T>>([&]<auto I>() {
+        if (Reflection::GetMemberAt<I>(lhs) != Reflection::GetMemberAt<I>(rhs))
+            ++count;
+    });
+    return count;
+}
+
+TEST_CASE("CollectDifferences.bytewise", "[benchmark]")
+{
+    auto records = std::vector<Numeric64>(1000);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        records[i].a0 = i;
+        records[i].b31 = static_cast<std::uint32_t>(i);
+    }
+
+    for (size_t const changes: { size_t { 0 }, size_t { 1 }, size_t { 8 } })
+    {
+        auto changed = records;
+        for (auto& record: changed)
+            for (size_t k = 0; k < changes; ++k)
+                reinterpret_cast<unsigned char*>(&record)[k * 43 % sizeof(Numeric64)] += 1;
+
+        auto const suffix = std::format(" ({} changed)", changes);
+        BENCHMARK("CollectDifferences" + suffix)
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < records.size(); ++i)
+                Reflection::CollectDifferences(
+                    records[i], changed[i], [&](size_t /*index*/, auto const& /*a*/, auto const& /*b*/) { ++count; });
+            return count;
+        };
+        BENCHMARK("member-wise" + suffix)
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < records.size(); ++i)
+                count += MemberwiseDifferences(records[i], changed[i]);
+            return count;
+        };
+    }
+}
+
+TEST_CASE("ToTuple", "[benchmark]")
+{
+    auto records = std::vector<Wide> {};
+    for (int i = 0; i < 1000; ++i)
+        records.push_back(MakeWide(i));
+
+    REFLECTION_BENCHMARK("GetMemberAt", {
+        double total = 0;
+        for (auto const& record: records)
+            total += Reflection::GetMemberAt<2>(record) + static_cast<double>(Reflection::GetMemberAt<9>(record));
+        return total;
+    });
+    REFLECTION_BENCHMARK("ToTuple", {
+        double total = 0;
+        for (auto const& record: records)
+        {
+            auto const tuple = Reflection::ToTuple(record);
+            total += std::get<2>(tuple) + static_cast<double>(std::get<9>(tuple));
+        }
+        return total;
+    });
+    REFLECTION_BENCHMARK("hand-written", {
+        double total = 0;
+        for (auto const& record: records)
+            total += record.a2 + static_cast<double>(record.a9);
+        return total;
+    });
+}
+
+TEST_CASE("AssignByName", "[benchmark]")
+{
+    auto records = std::vector<Wide> {};
+    for (int i = 0; i < 1000; ++i)
+        records.push_back(MakeWide(i));
+    auto reversed = std::vector<WideReversed>(records.size());
+    auto copies = std::vector<WideCopy>(records.size());
+
+    REFLECTION_BENCHMARK("reordered members", {
+        for (size_t i = 0; i < records.size(); ++i)
+            Reflection::AssignByName(reversed[i], records[i]);
+        return reversed.back().a0;
+    });
+    REFLECTION_BENCHMARK("identical layout", {
+        for (size_t i = 0; i < records.size(); ++i)
+            Reflection::AssignByName(copies[i], records[i]);
+        return copies.back().a0;
+    });
+    REFLECTION_BENCHMARK("hand-written", {
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            auto const& r = records[i];
+            reversed[i] = WideReversed { r.a15, r.a14, r.a13, r.a12, r.a11, r.a10, r.a9, r.a8,
+                                         r.a7,  r.a6,  r.a5,  r.a4,  r.a3,  r.a2,  r.a1, r.a0 };
+        }
+        return reversed.back().a0;
+    });
+}
+
+// ---------------------------------------------------------------------------
+// algorithms over ranges of objects
+
+TEST_CASE("ReduceMembers", "[benchmark]")
+{
+    auto records = std::vector<Wide> {};
+    for (int i = 0; i < 1'000'000; ++i)
+        records.push_back(MakeWide(i));
+
+    BENCHMARK("Sum")
+    {
+        return std::get<2>(Reflection::ReduceMembers(records, Reflection::Reduce::Sum {}));
+    };
+    BENCHMARK("Sum, parallel")
+    {
+        return std::get<2>(
+            Reflection::ReduceMembers(records, Reflection::Reduce::Sum {}, Reflection::Parallelism::Hardware()));
+    };
+    BENCHMARK("Mean")
+    {
+        return std::get<2>(Reflection::ReduceMembers(records, Reflection::Reduce::Mean {}));
+    };
+    BENCHMARK("hand-written sum of every member")
+    {
+        // The same accumulator types as Reduce::Sum: 64 bit integers for integral members, double otherwise.
+        std::int64_t a0 = 0, a1 = 0, a5 = 0, a8 = 0, a9 = 0, a13 = 0;
+        std::uint64_t a4 = 0, a6 = 0, a12 = 0, a14 = 0;
+        double a2 = 0, a3 = 0, a7 = 0, a10 = 0, a11 = 0, a15 = 0;
+        for (auto const& r: records)
+        {
+            a0 += r.a0, a1 += r.a1, a2 += r.a2, a3 += r.a3, a4 += r.a4, a5 += r.a5, a6 += r.a6, a7 += r.a7;
+            a8 += r.a8, a9 += r.a9, a10 += r.a10, a11 += r.a11, a12 += r.a12, a13 += r.a13, a14 += r.a14, a15 += r.a15;
+        }
+        return a2 + a3 + a7 + a10 + a11 + a15 + double(a0 + a1 + a5 + a8 + a9 + a13) + double(a4 + a6 + a12 + a14);
+    };
+}
+
+TEST_CASE("TransformMembers", "[benchmark]")
+{
+    auto records = std::vector<Wide> {};
+    for (int i = 0; i < 1'000'000; ++i)
+        records.push_back(MakeWide(i));
+
+    using Doubles = std::index_sequence<2, 7, 10, 15>;
+    auto const scale = [](auto& value) { value *= 1.0001; };
+
+    BENCHMARK("TransformMembers")
+    {
+        Reflection::TransformMembers(records, Doubles {}, scale);
+        return records.back().a2;
+    };
+    BENCHMARK("TransformMembers, parallel")
+    {
+        Reflection::TransformMembers(records, Doubles {}, scale, Reflection::Parallelism::Hardware());
+        return records.back().a2;
+    };
+    BENCHMARK("EnumerateMembers per record")
+    {
+        for (auto& record: records)
+            Reflection::EnumerateMembers<Doubles, Wide>(
+                [&]<size_t I, typename>() { scale(Reflection::GetMemberAt<I>(record)); });
+        return records.back().a2;
+    };
+}
+
+struct Execution
+{
+    std::int64_t timestamp {};
+    std::int16_t venue {};
+    float price {};
+    double quantity {};
+    std::uint64_t orderId {};
+};
+
+// Timestamps spread over the whole range, while venues take only a few values such that sorting by venue and price
+// needs the secondary key.
+template <>
+struct Reflection::GenerateDistribution<std::int64_t>
+{
+    static constexpr auto max = std::numeric_limits<std::int64_t>::max();
+};
+
+template <>
+struct Reflection::GenerateDistribution<std::int16_t>
+{
+    static constexpr std::int16_t max = 15;
+};
+
+TEST_CASE("SortBy", "[benchmark]")
+{
+    constexpr size_t Count = 10'000'000;
+    auto rng = std::mt19937_64 { 42 };
+    auto const records = Reflection::Generate<Execution>(rng, Count);
+
+    // Every run sorts a fresh copy, the copy is part of all measurements.
+    BENCHMARK("SortBy<&Execution::timestamp>")
+    {
+        auto copy = records;
+        Reflection::SortBy<&Execution::timestamp>(copy);
+        return copy.front().orderId;
+    };
+    BENCHMARK("std::sort by timestamp")
+    {
+        auto copy = records;
+        std::sort(copy.begin(), copy.end(), [](auto const& a, auto const& b) { return a.timestamp < b.timestamp; });
+        return copy.front().orderId;
+    };
+    BENCHMARK("SortBy<&Execution::venue, &Execution::price>")
+    {
+        auto copy = records;
+        Reflection::SortBy<&Execution::venue, &Execution::price>(copy);
+        return copy.front().orderId;
+    };
+    BENCHMARK("std::sort by venue, price")
+    {
+        auto copy = records;
+        std::sort(copy.begin(), copy.end(), [](auto const& a, auto const& b) {
+            return a.venue < b.venue || (a.venue == b.venue && a.price < b.price);
+        });
+        return copy.front().orderId;
+    };
+}
+
+// ---------------------------------------------------------------------------
+// binary formats
+
+TEST_CASE("Binary.tagged_vs_fixed", "[benchmark]")
+{
+    auto const customers = MakeCustomers(1000);
+
+    auto fixed = std::vector<std::byte> {};
+    auto tagged = std::vector<std::byte> {};
+    for (auto const& customer: customers)
+    {
+        Reflection::SerializeBinary(customer, fixed);
+        Reflection::SerializeTagged(customer, tagged);
+    }
+
+    BENCHMARK("serialize fixed")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(fixed.size());
+        for (auto const& customer: customers)
+            Reflection::SerializeBinary(customer, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("serialize tagged")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(tagged.size());
+        for (auto const& customer: customers)
+            Reflection::SerializeTagged(customer, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("deserialize fixed")
+    {
+        auto reader = Reflection::BinaryReader { fixed };
+        auto customer = Customer {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::DeserializeBinary(reader, customer))
+            ++count;
+        return count;
+    };
+
+    BENCHMARK("deserialize tagged")
+    {
+        auto reader = Reflection::BinaryReader { tagged };
+        auto customer = Customer {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::DeserializeTagged(reader, customer))
+            ++count;
+        return count;
+    };
+
+    BENCHMARK("deserialize tagged, older reader skipping unknown fields")
+    {
+        auto reader = Reflection::BinaryReader { tagged };
+        auto customer = CustomerV1 {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::DeserializeTagged(reader, customer))
+            ++count;
+        return count;
+    };
+}
+
+TEMPLATE_TEST_CASE("Binary.compact_vs_fixed", "[benchmark]", Customer, Wide)
+{
+    constexpr size_t Count = 10'000;
+    auto records = std::vector<TestType> {};
+    if constexpr (std::is_same_v<TestType, Customer>)
+        records = MakeCustomers(Count);
+    else
+        for (size_t i = 0; i < Count; ++i)
+            records.push_back(MakeWide(static_cast<int>(i)));
+
+    auto fixed = std::vector<std::byte> {};
+    auto compact = std::vector<std::byte> {};
+    for (auto const& record: records)
+    {
+        Reflection::SerializeBinary(record, fixed);
+        Reflection::SerializeCompact(record, compact);
+    }
+    std::cout << std::format("fixed: {} bytes, compact: {} bytes ({:.1f}% smaller)\n",
+                             fixed.size(),
+                             compact.size(),
+                             100.0 - 100.0 * static_cast<double>(compact.size()) / static_cast<double>(fixed.size()));
+
+    BENCHMARK("serialize fixed")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(fixed.size());
+        for (auto const& record: records)
+            Reflection::SerializeBinary(record, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("serialize compact")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(compact.size());
+        for (auto const& record: records)
+            Reflection::SerializeCompact(record, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("deserialize fixed")
+    {
+        auto reader = Reflection::BinaryReader { fixed };
+        auto record = TestType {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::DeserializeBinary(reader, record))
+            ++count;
+        return count;
+    };
+
+    BENCHMARK("deserialize compact")
+    {
+        auto reader = Reflection::BinaryReader { compact };
+        auto record = TestType {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::DeserializeCompact(reader, record))
+            ++count;
+        return count;
+    };
+}
+
+TEST_CASE("MsgPack", "[benchmark]")
+{
+    auto const customers = MakeCustomers(10'000);
+
+    auto map = std::vector<std::byte> {};
+    auto array = std::vector<std::byte> {};
+    for (auto const& customer: customers)
+    {
+        Reflection::ToMsgPack(customer, map);
+        Reflection::ToMsgPack<Reflection::MsgPackLayout::Array>(customer, array);
+    }
+    std::cout << std::format("MessagePack map: {} bytes, array: {} bytes\n", map.size(), array.size());
+
+    BENCHMARK("ToMsgPack, map")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(map.size());
+        for (auto const& customer: customers)
+            Reflection::ToMsgPack(customer, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("ToMsgPack, array")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(array.size());
+        for (auto const& customer: customers)
+            Reflection::ToMsgPack<Reflection::MsgPackLayout::Array>(customer, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("FromMsgPack, map")
+    {
+        auto reader = Reflection::BinaryReader { map };
+        auto customer = Customer {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::FromMsgPack(reader, customer))
+            ++count;
+        return count;
+    };
+
+    BENCHMARK("FromMsgPack, array")
+    {
+        auto reader = Reflection::BinaryReader { array };
+        auto customer = Customer {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::FromMsgPack(reader, customer))
+            ++count;
+        return count;
+    };
+
+    BENCHMARK("FromMsgPack, map read by an older type")
+    {
+        auto reader = Reflection::BinaryReader { map };
+        auto customer = CustomerV1 {};
+        size_t count = 0;
+        while (reader.remaining() > 0 && Reflection::FromMsgPack(reader, customer))
+            ++count;
+        return count;
+    };
+}
+
+// The same layout as Customer, with all strings and vectors allocating from a memory resource.
+struct PmrAddress
+{
+    std::pmr::string street;
+    std::pmr::string city;
+    int zip {};
+};
+
+struct PmrCustomer
+{
+    std::uint64_t id {};
+    std::pmr::string name;
+    std::pmr::string email;
+    int age {};
+    double balance {};
+    bool active {};
+    PmrAddress address;
+    std::pmr::vector<std::pmr::string> tags;
+};
+
+TEST_CASE("Binary.arena", "[benchmark]")
+{
+    constexpr size_t Count = 1'000'000;
+    auto const input = [] {
+        auto buffer = std::vector<std::byte> {};
+        for (auto const& customer: MakeCustomers(Count))
+            Reflection::SerializeBinary(customer, buffer);
+        return buffer;
+    }();
+
+    // Every run decodes the whole batch and frees it again, freeing is part of all measurements.
+    auto const decodeGlobal = [&] {
+        auto customers = std::vector<Customer> {};
+        auto reader = Reflection::BinaryReader { input };
+        while (reader.remaining() > 0)
+            if (!Reflection::DeserializeBinary(reader, customers.emplace_back()))
+                break;
+        return customers.size();
+    };
+    // The arena's buffer is reused from batch to batch, as a batch decoder would do.
+    auto storage = std::vector<std::byte>(input.size() * 4);
+    auto const decodeArena = [&] {
+        auto arena = std::pmr::monotonic_buffer_resource { storage.data(), storage.size() };
+        auto customers = std::pmr::vector<PmrCustomer> { &arena };
+        if (!Reflection::DeserializeBinaryBatch(input, customers))
+            return size_t { 0 };
+        return customers.size();
+    };
+
+    auto const reportAllocations = [&](std::string_view name, auto const& decode) {
+        auto const before = allocationCount.load();
+        CHECK(decode() == Count);
+        std::cout << std::format("{:<48} {:8.2f} allocations/record\n",
+                                 name,
+                                 static_cast<double>(allocationCount.load() - before) / Count);
+    };
+    reportAllocations("decode 1M records, global allocator", decodeGlobal);
+    reportAllocations("decode 1M records, monotonic arena", decodeArena);
+
+    BENCHMARK("decode 1M records, global allocator")
+    {
+        return decodeGlobal();
+    };
+    BENCHMARK("decode 1M records, monotonic arena")
+    {
+        return decodeArena();
+    };
+}
+
+TEST_CASE("Delta", "[benchmark]")
+{
+    auto const before = MakeCustomers(1000);
+    auto after = before;
+    for (auto& customer: after)
+    {
+        customer.balance += 10.0;
+        customer.address.zip += 1;
+    }
+
+    auto full = std::vector<std::byte> {};
+    auto delta = std::vector<std::byte> {};
+    for (size_t i = 0; i < before.size(); ++i)
+    {
+        Reflection::SerializeBinary(after[i], full);
+        Reflection::EncodeDelta(before[i], after[i], delta);
+    }
+    std::cout << std::format("full state: {} bytes, delta: {} bytes ({:.1f}x smaller)\n",
+                             full.size(),
+                             delta.size(),
+                             static_cast<double>(full.size()) / static_cast<double>(delta.size()));
+
+    BENCHMARK("CollectDifferences")
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < before.size(); ++i)
+            Reflection::CollectDifferences(
+                before[i], after[i], [&](std::string_view /*name*/, auto const& /*a*/, auto const& /*b*/) { ++count; });
+        return count;
+    };
+
+    BENCHMARK("EncodeDelta")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(delta.size());
+        for (size_t i = 0; i < before.size(); ++i)
+            Reflection::EncodeDelta(before[i], after[i], buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("SerializeBinary")
+    {
+        auto buffer = std::vector<std::byte> {};
+        buffer.reserve(full.size());
+        for (auto const& customer: after)
+            Reflection::SerializeBinary(customer, buffer);
+        return buffer.size();
+    };
+
+    BENCHMARK("ApplyDelta")
+    {
+        auto states = before;
+        auto reader = Reflection::BinaryReader { delta };
+        for (auto& state: states)
+            std::ignore = Reflection::ApplyDelta(state, reader);
+        return states.back().balance;
+    };
+}
+
+// ---------------------------------------------------------------------------
+// columnar files
+
+struct Tick
+{
+    std::int64_t timestamp {};
+    double price {};
+    double size {};
+    std::int32_t venue {};
+    std::string symbol;
+};
+
+TEST_CASE("Columnar.scan", "[benchmark]")
+{
+    constexpr size_t Rows = 1'000'000;
+    auto const path = std::filesystem::temp_directory_path() / "reflection-cpp-bench-columnar.bin";
+
+    auto writer = Reflection::ColumnWriter<Tick> {};
+    REQUIRE(writer.Open(path));
+    auto rows = std::vector<std::byte> {};
+    for (size_t i = 0; i < Rows; ++i)
+    {
+        auto const tick = Tick { .timestamp = static_cast<std::int64_t>(i),
+                                 .price = 100.0 + static_cast<double>(i % 100),
+                                 .size = 1.0,
+                                 .venue = static_cast<std::int32_t>(i % 7),
+                                 .symbol = i % 2 ? "ACME" : "INITECH" };
+        writer.Append(tick);
+        Reflection::SerializeBinary(tick, rows);
+    }
+    REQUIRE(writer.Close());
+
+    auto reader = Reflection::ColumnReader<Tick> {};
+    REQUIRE(reader.Open(path));
+
+    BENCHMARK("sum of one column, mapped file")
+    {
+        double total = 0;
+        for (size_t group = 0; group < reader.rowGroups(); ++group)
+            for (auto const price: reader.Column<&Tick::price>(group))
+                total += price;
+        return total;
+    };
+
+    BENCHMARK("sum of one column, decoding rows")
+    {
+        auto input = Reflection::BinaryReader { rows };
+        auto tick = Tick {};
+        double total = 0;
+        while (input.remaining() > 0 && Reflection::DeserializeBinary(input, tick))
+            total += tick.price;
+        return total;
+    };
+
+    BENCHMARK("count of one string value, mapped file")
+    {
+        size_t count = 0;
+        for (size_t group = 0; group < reader.rowGroups(); ++group)
+        {
+            auto const symbols = reader.Column<&Tick::symbol>(group);
+            for (size_t i = 0; i < symbols.size(); ++i)
+                count += symbols[i] == "ACME";
+        }
+        return count;
+    };
+
+    reader.Close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("IndexedVector", "[benchmark]")
+{
+    constexpr size_t Count = 10'000;
+    auto const customers = MakeCustomers(Count);
+    auto indexed = Reflection::IndexedVector<Customer, &Customer::id, &Customer::email> {};
+    indexed.Reserve(Count);
+    for (auto const& customer: customers)
+        indexed.Insert(customer);
+
+    auto emails = std::vector<std::string> {};
+    for (size_t i = 0; i < Count; i += 10)
+        emails.push_back(customers[(i * 7919) % Count].email);
+
+    BENCHMARK("Find by email")
+    {
+        size_t found = 0;
+        for (auto const& email: emails)
+            found += indexed.Find<&Customer::email>(email);
+        return found;
+    };
+
+    BENCHMARK("linear search by email")
+    {
+        size_t found = 0;
+        for (auto const& email: emails)
+            found += static_cast<size_t>(
+                std::ranges::find(customers, email, &Customer::email) - customers.begin());
+        return found;
+    };
+
+    BENCHMARK("Set of a member that is not indexed")
+    {
+        for (size_t i = 0; i < Count; ++i)
+            indexed.Set<&Customer::balance>(i, indexed[i].balance + 1.0);
+        return indexed[0].balance;
+    };
+
+    BENCHMARK("Update changing an indexed member")
+    {
+        for (size_t i = 0; i < Count; ++i)
+            indexed.Update(i, [&](Customer& customer) { customer.id += Count; });
+        return indexed[0].id;
+    };
+}
+
+TEST_CASE("DeferredLog", "[benchmark]")
+{
+    // Latency on the producer thread of logging a record: formatting it eagerly with Inspect versus capturing it for
+    // the background thread of a DeferredLog. Every record is timed individually to report percentiles, and the log
+    // is large enough that no record is dropped.
+    constexpr size_t Records = 50'000;
+    auto const wide = MakeWide(42);
+    auto const narrow = MakeNarrow(42);
+    auto log = Reflection::DeferredLog<> { Records, [](std::string_view /*line*/) {} };
+    auto latencies = std::vector<std::int64_t>(Records);
+    size_t eagerBytes = 0;
+
+    auto const report = [&](std::string_view name, auto&& logRecord) {
+        log.Flush();
+        for (auto& latency: latencies)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            logRecord();
+            latency = std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count();
+        }
+        std::ranges::sort(latencies);
+        std::cout << std::format("{:<48} median {:6} ns  p99 {:6} ns  p99.9 {:6} ns\n",
+                                 name,
+                                 latencies[Records / 2],
+                                 latencies[Records * 99 / 100],
+                                 latencies[Records * 999 / 1000]);
+    };
+
+    report("eager Inspect, Wide", [&] { eagerBytes += Reflection::Inspect(wide).size(); });
+    report("Deferred, Wide (bytes)", [&] { log.Push(Reflection::Deferred(wide)); });
+    report("eager Inspect, Narrow", [&] { eagerBytes += Reflection::Inspect(narrow).size(); });
+    report("Deferred, Narrow (encoded)", [&] { log.Push(Reflection::Deferred(narrow)); });
+    report("Deferred, Narrow (reference)", [&] { log.Push(Reflection::Deferred(std::cref(narrow))); });
+
+    log.Flush();
+    CHECK(eagerBytes > 0);
+    CHECK(log.Dropped() == 0);
+}
+
+// ---------------------------------------------------------------------------
+// data generation
+
+TEST_CASE("Generate", "[benchmark]")
+{
+    constexpr size_t Count = 100'000;
+    auto rng = std::mt19937_64 { 42 };
+
+    BENCHMARK("Generate<Customer>, 100k records")
+    {
+        return Reflection::Generate<Customer>(rng, Count).size();
+    };
+
+    BENCHMARK("Generate<Execution>, 100k records")
+    {
+        return Reflection::Generate<Execution>(rng, Count).size();
+    };
+
+    auto executions = std::vector<Execution>(Count);
+    BENCHMARK("Generate into a preallocated vector<Execution>, 100k records")
+    {
+        Reflection::Generate(rng, std::span { executions });
+        return executions.back().orderId;
+    };
+}
+
+// ---------------------------------------------------------------------------
+// memory footprint
+
+TEST_CASE("DeepSizeOf", "[benchmark]")
+{
+    auto const customers = MakeCustomers(100'000);
+    auto const report = Reflection::DeepSizeReport(customers);
+    for (auto const& member: report.members)
+        std::cout << std::format("{:<48} {:10} inline bytes {:10} heap bytes\n",
+                                 member.name,
+                                 member.inlineBytes,
+                                 member.heapBytes);
+
+    BENCHMARK("DeepSizeOf, 100k customers")
+    {
+        return Reflection::DeepSizeOf(std::span { customers });
+    };
+
+    BENCHMARK("DeepSizeReport, 100k customers")
+    {
+        return Reflection::DeepSizeReport(customers).total();
+    };
+}
+
+struct CustomerBook
+{
+    std::string name;
+    std::vector<Customer> customers;
+};
+
+TEST_CASE("Binary.chunks", "[benchmark]")
+{
+    constexpr size_t SocketBufferSize = 64 * 1024;
+    auto const book = CustomerBook { .name = "customers", .customers = MakeCustomers(100'000) };
+
+    // Stands in for a socket send, copying every byte once into a buffer of fixed size.
+    auto socketBuffer = std::vector<std::byte>(SocketBufferSize);
+    auto const send = [&](std::span<std::byte const> bytes) {
+        for (size_t offset = 0; offset < bytes.size(); offset += SocketBufferSize)
+        {
+            auto const count = std::min(SocketBufferSize, bytes.size() - offset);
+            std::copy_n(bytes.data() + offset, count, socketBuffer.data());
+        }
+        return bytes.size();
+    };
+
+    auto const materialize = [&] {
+        auto buffer = std::vector<std::byte> {};
+        Reflection::SerializeBinary(book, buffer);
+        return send(buffer);
+    };
+    auto const stream = [&] {
+        size_t total = 0;
+        for (auto const chunk: Reflection::SerializeChunks(book, SocketBufferSize))
+            total += send(chunk);
+        return total;
+    };
+
+    // Memory allocated while serializing once, an upper bound of the memory held at any time.
+    auto const allocatedBy = [](auto const& f) {
+        auto const before = allocationBytes.load();
+        [[maybe_unused]] auto const result = f();
+        return allocationBytes.load() - before;
+    };
+    std::cout << std::format("{} bytes serialized, {} bytes allocated when materialized, {} bytes when streamed\n",
+                             materialize(),
+                             allocatedBy(materialize),
+                             allocatedBy(stream));
+
+    BENCHMARK("SerializeBinary, then send")
+    {
+        return materialize();
+    };
+
+    BENCHMARK("SerializeChunks, sending every chunk")
+    {
+        return stream();
+    };
+}
+
+struct Quote
+{
+    std::uint64_t sequence {};
+    double bid {};
+    double ask {};
+    std::int64_t bidSize {};
+    std::int64_t askSize {};
+    std::int64_t timestamp {};
+};
+
+// The alternative to SeqLocked: readers copy the value under a mutex shared with the writer.
+class MutexQuote
+{
+  public:
+    void store(Quote const& quote)
+    {
+        auto const lock = std::scoped_lock { _mutex };
+        _quote = quote;
+    }
+
+    [[nodiscard]] Quote load() const
+    {
+        auto const lock = std::scoped_lock { _mutex };
+        return _quote;
+    }
+
+    [[nodiscard]] double bid() const
+    {
+        auto const lock = std::scoped_lock { _mutex };
+        return _quote.bid;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    Quote _quote;
+};
+
+TEST_CASE("SeqLocked", "[benchmark]")
+{
+    auto seqLocked = Reflection::SeqLocked<Quote> {};
+    auto mutexed = MutexQuote {};
+
+    auto const benchmarkReads = [&](std::string_view scenario) {
+        BENCHMARK(std::format("SeqLocked::load, {}", scenario))
+        {
+            return seqLocked.load();
+        };
+        BENCHMARK(std::format("SeqLocked::load<&Quote::bid>, {}", scenario))
+        {
+            return seqLocked.load<&Quote::bid>();
+        };
+        BENCHMARK(std::format("mutex, whole quote, {}", scenario))
+        {
+            return mutexed.load();
+        };
+        BENCHMARK(std::format("mutex, bid only, {}", scenario))
+        {
+            return mutexed.bid();
+        };
+    };
+
+    benchmarkReads("no writer");
+
+    // A publisher updating both quotes as fast as it can, at the expense of the readers.
+    auto writer = std::jthread { [&](std::stop_token stop) {
+        for (std::uint64_t n = 0; !stop.stop_requested(); ++n)
+        {
+            auto const quote = Quote { .sequence = n,
+                                       .bid = static_cast<double>(n),
+                                       .ask = static_cast<double>(n + 1),
+                                       .bidSize = 100,
+                                       .askSize = 200,
+                                       .timestamp = static_cast<std::int64_t>(n) };
+            seqLocked.store(quote);
+            mutexed.store(quote);
+        }
+    } };
+    benchmarkReads("concurrent writer");
+}
+
+#if !defined(_WIN32)
+
+struct Document
+{
+    std::uint64_t id {};
+    std::string title;
+    std::string body;
+    std::vector<std::uint8_t> attachment;
+    std::vector<std::string> tags;
+};
+
+TEST_CASE("GatherWriter", "[benchmark]")
+{
+    constexpr size_t BufferSize = Reflection::GatherWriter::DefaultStagingSize;
+    auto documents = std::vector<Document>(10'000);
+    auto rng = std::mt19937_64 { 42 };
+    for (auto& document: documents)
+    {
+        Reflection::GenerateInto(rng, document.id);
+        Reflection::GenerateInto(rng, document.title);
+        Reflection::GenerateInto(rng, document.tags);
+        document.body = std::string(4096, 'b');
+        document.attachment = std::vector<std::uint8_t>(1024, 0xA5);
+    }
+
+    auto const path = std::filesystem::temp_directory_path() / "reflection-cpp-bench-gather.bin";
+    auto const openFile = [&] { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); };
+    auto buffer = std::vector<std::byte> {};
+    buffer.reserve(2 * BufferSize);
+
+    BENCHMARK("SerializeBinary into a buffer, write")
+    {
+        auto const fd = openFile();
+        size_t total = 0;
+        for (auto const& document: documents)
+        {
+            Reflection::SerializeBinary(document, buffer);
+            if (buffer.size() >= BufferSize)
+            {
+                total += static_cast<size_t>(::write(fd, buffer.data(), buffer.size()));
+                buffer.clear();
+            }
+        }
+        total += static_cast<size_t>(::write(fd, buffer.data(), buffer.size()));
+        buffer.clear();
+        ::close(fd);
+        return total;
+    };
+
+    BENCHMARK("GatherWriter, writev")
+    {
+        auto const fd = openFile();
+        auto writer = Reflection::GatherWriter { fd, BufferSize };
+        for (auto const& document: documents)
+            writer.Write(document);
+        auto const good = writer.Flush();
+        ::close(fd);
+        return good;
+    };
+
+    std::filesystem::remove(path);
+}
+
+#endif
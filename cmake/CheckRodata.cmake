@@ -0,0 +1,28 @@
+# Verifies that no prettified function signatures, which are used to extract names at compile time,
+# survive in the read-only data section of a binary.
+#
+# Usage: cmake -DOBJCOPY=<objcopy> -DBINARY=<binary> -DOUTPUT=<scratch file> -P CheckRodata.cmake
+
+foreach(var OBJCOPY BINARY OUTPUT)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CheckRodata: ${var} is not set")
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND "${OBJCOPY}" -O binary --only-section=.rodata "${BINARY}" "${OUTPUT}"
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "CheckRodata: failed to extract .rodata from ${BINARY}")
+endif()
+
+file(STRINGS "${OUTPUT}" signatures REGEX "Reflection::detail::(MangledName|GetName)")
+list(LENGTH signatures count)
+if(count GREATER 0)
+    foreach(signature IN LISTS signatures)
+        message(STATUS "  ${signature}")
+    endforeach()
+    message(FATAL_ERROR "CheckRodata: ${count} prettified function signature(s) found in ${BINARY}")
+endif()
+message(STATUS "CheckRodata: no prettified function signatures found in ${BINARY}")
@@ -0,0 +1,46 @@
+# Verifies that a program using the facilities built on the never defined Reflection::detail::External<T>
+# links without optimizations, where constexpr variables holding addresses into it would be emitted.
+#
+# Usage: cmake -DCXX=<compiler> -DINCLUDE_DIR=<include dir> -DWORK_DIR=<scratch dir> -P CheckUnoptimizedLink.cmake
+
+foreach(var CXX INCLUDE_DIR WORK_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CheckUnoptimizedLink: ${var} is not set")
+    endif()
+endforeach()
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(WRITE "${WORK_DIR}/unoptimized-link.cpp" [=[
+#include <reflection-cpp/reflection.hpp>
+
+struct Point
+{
+    int x;
+    double y;
+    int z;
+};
+
+int main()
+{
+    auto const p = Point { .x = 1, .y = 2.0, .z = 3 };
+    auto const names = Reflection::MemberNames<Point>;
+    auto const index = Reflection::MemberIndexOf<&Point::y> + Reflection::MemberIndexOf<&Point::z>;
+    return index == 3 && names[1] == "y" && Reflection::GetMemberAt<2>(p) == 3 ? 0 : 1;
+}
+]=])
+
+execute_process(
+    COMMAND "${CXX}" -std=c++20 -O0 -I "${INCLUDE_DIR}" "${WORK_DIR}/unoptimized-link.cpp"
+            -o "${WORK_DIR}/unoptimized-link"
+    RESULT_VARIABLE result
+    ERROR_VARIABLE errors
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "CheckUnoptimizedLink: building at -O0 failed:\n${errors}")
+endif()
+
+execute_process(COMMAND "${WORK_DIR}/unoptimized-link" RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "CheckUnoptimizedLink: the program built at -O0 returned ${result}")
+endif()
+message(STATUS "CheckUnoptimizedLink: linked and ran at -O0")
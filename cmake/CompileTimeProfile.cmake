@@ -0,0 +1,255 @@
+# Compile-time profiling of the reflection header.
+#
+# Generates synthetic aggregates of varying width (number of members) and nesting depth,
+# and for every facility a translation unit exercising only that facility on all of them.
+# Each translation unit is compiled with -ftime-trace (Clang) or -ftime-report (GCC), and the reported timings
+# are aggregated into a report, relative to a baseline translation unit that only defines the aggregates.
+#
+# Usage:
+#   cmake -DCXX=<compiler> -DCXX_ID=<GNU|Clang> -DINCLUDE_DIR=<dir> -DWORK_DIR=<dir>
+#         [-DWIDTHS=8;32;96] [-DDEPTHS=1;3] [-DREPEAT=3] [-DFACILITIES=...] [-DCXX_FLAGS=...]
+#         [-DBASELINE=<report.csv>] [-DTOLERANCE=<percent>]
+#         -P CompileTimeProfile.cmake
+#
+# If BASELINE is given, the run fails if any facility got slower than the baseline by more than TOLERANCE percent
+# (plus a fixed slack of 50 ms to absorb noise).
+
+cmake_minimum_required(VERSION 3.10)
+
+foreach(var CXX CXX_ID INCLUDE_DIR WORK_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "CompileTimeProfile: ${var} is not set")
+    endif()
+endforeach()
+
+if(NOT DEFINED WIDTHS)
+    set(WIDTHS 8 32 96)
+endif()
+if(NOT DEFINED DEPTHS)
+    set(DEPTHS 1 3)
+endif()
+if(NOT DEFINED REPEAT)
+    set(REPEAT 3)
+endif()
+if(NOT DEFINED FACILITIES)
+    set(FACILITIES CountMembers ToTuple MemberNameOf MemberIndexOf MemberIndexOfByName TypeNameOf Inspect)
+endif()
+if(NOT DEFINED CXX_FLAGS)
+    set(CXX_FLAGS -std=c++20)
+endif()
+if(NOT DEFINED TOLERANCE)
+    set(TOLERANCE 25)
+endif()
+
+if(CXX_ID MATCHES "Clang")
+    set(profile_flag -ftime-trace)
+elseif(CXX_ID STREQUAL "GNU")
+    set(profile_flag -ftime-report)
+else()
+    message(FATAL_ERROR "CompileTimeProfile: unsupported compiler ${CXX_ID}, only Clang and GCC are supported")
+endif()
+
+set(member_types "int" "double" "std::string" "bool")
+
+# ---------------------------------------------------------------------------
+# source generation
+
+# Writes the synthetic aggregates: Level0 holds only scalar members,
+# every LevelN (N > 0) holds LevelN-1 as its first member followed by scalar members.
+function(generate_structs path width depth)
+    set(content "// Generated by CompileTimeProfile.cmake\n#pragma once\n\n#include <string>\n\n")
+    string(APPEND content "template <int>\nstruct Tag\n{\n};\n")
+    math(EXPR last_level "${depth} - 1")
+    math(EXPR last_member "${width} - 1")
+    foreach(level RANGE ${last_level})
+        string(APPEND content "\nstruct Level${level}\n{\n")
+        foreach(member RANGE ${last_member})
+            if(level GREATER 0 AND member EQUAL 0)
+                math(EXPR inner "${level} - 1")
+                string(APPEND content "    Level${inner} m0;\n")
+            else()
+                math(EXPR type_index "${member} % 4")
+                list(GET member_types ${type_index} type)
+                string(APPEND content "    ${type} m${member} {};\n")
+            endif()
+        endforeach()
+        string(APPEND content "};\n")
+    endforeach()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+function(generate_facility path facility width depth)
+    set(content "// Generated by CompileTimeProfile.cmake\n")
+    string(APPEND content "#include <reflection-cpp/reflection.hpp>\n\n#include \"structs.hpp\"\n\n")
+    string(APPEND content "#include <string>\n#include <tuple>\n\n")
+    math(EXPR last_level "${depth} - 1")
+    math(EXPR last_member "${width} - 1")
+    foreach(level RANGE ${last_level})
+        set(S "Level${level}")
+        if(facility STREQUAL "CountMembers")
+            string(APPEND content "static_assert(Reflection::CountMembers<${S}> == ${width});\n")
+        elseif(facility STREQUAL "ToTuple")
+            string(APPEND content
+                "decltype(auto) ToTuple${level}(${S}& s)\n{\n    return Reflection::ToTuple(s);\n}\n")
+        elseif(facility STREQUAL "MemberNameOf")
+            foreach(member RANGE ${last_member})
+                string(APPEND content
+                    "static_assert(Reflection::MemberNameOf<${member}, ${S}> == \"m${member}\");\n")
+            endforeach()
+        elseif(facility MATCHES "^MemberIndexOf")
+            set(variable "${facility}")
+            if(facility STREQUAL "MemberIndexOfByName")
+                # the former implementation matching member names, to compare against the address based one
+                set(variable "detail::MemberIndexOfByName")
+            endif()
+            foreach(member RANGE ${last_member})
+                string(APPEND content
+                    "static_assert(Reflection::${variable}<&${S}::m${member}> == ${member});\n")
+            endforeach()
+        elseif(facility STREQUAL "TypeNameOf")
+            string(APPEND content "static_assert(Reflection::TypeNameOf<${S}> == \"${S}\");\n")
+            foreach(member RANGE ${last_member})
+                string(APPEND content
+                    "static_assert(!Reflection::TypeNameOf<Tag<${level} * 1000 + ${member}>>.empty());\n")
+            endforeach()
+        elseif(facility STREQUAL "Inspect")
+            string(APPEND content
+                "std::string Inspect${level}(${S} const& s)\n{\n    return Reflection::Inspect(s);\n}\n")
+        elseif(NOT facility STREQUAL "Baseline")
+            message(FATAL_ERROR "CompileTimeProfile: unknown facility ${facility}")
+        endif()
+    endforeach()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+# ---------------------------------------------------------------------------
+# timing extraction
+
+# Converts a decimal number of seconds (e.g. "0.12") into integer milliseconds.
+function(seconds_to_ms seconds out)
+    if(seconds MATCHES "^([0-9]+)\\.([0-9]*)$")
+        set(whole "${CMAKE_MATCH_1}")
+        set(fraction "${CMAKE_MATCH_2}000")
+        string(SUBSTRING "${fraction}" 0 3 fraction)
+        string(REGEX REPLACE "^0+([0-9])" "\\1" fraction "${fraction}")
+        math(EXPR ms "${whole} * 1000 + ${fraction}")
+    else()
+        set(ms 0)
+    endif()
+    set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+# Reads the wall time of a phase from GCC's -ftime-report output.
+function(gcc_phase_ms report phase out)
+    set(ms 0)
+    string(REGEX MATCH " ${phase} +: +[0-9.]+ +(\\( *[0-9]+%\\) +)?[0-9.]+ +(\\( *[0-9]+%\\) +)?([0-9.]+)" line "${report}")
+    if(line)
+        seconds_to_ms("${CMAKE_MATCH_3}" ms)
+    endif()
+    set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+# Reads the accumulated duration of an event from Clang's -ftime-trace output.
+function(clang_total_ms trace event out)
+    set(ms 0)
+    string(REGEX MATCH "\"dur\":([0-9]+),\"name\":\"Total ${event}\"" match "${trace}")
+    if(match)
+        math(EXPR ms "${CMAKE_MATCH_1} / 1000")
+    endif()
+    set(${out} ${ms} PARENT_SCOPE)
+endfunction()
+
+# Compiles a source file once and returns its total and template instantiation times in milliseconds.
+function(compile_once source total_out instantiation_out)
+    get_filename_component(dir "${source}" DIRECTORY)
+    get_filename_component(name "${source}" NAME_WE)
+    set(object "${dir}/${name}.o")
+    execute_process(
+        COMMAND "${CXX}" ${CXX_FLAGS} ${profile_flag} "-I${INCLUDE_DIR}" -c "${source}" -o "${object}"
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "CompileTimeProfile: failed to compile ${source}:\n${output}")
+    endif()
+    if(CXX_ID MATCHES "Clang")
+        file(READ "${dir}/${name}.json" trace)
+        clang_total_ms("${trace}" "ExecuteCompiler" total)
+        clang_total_ms("${trace}" "InstantiateFunction" functions)
+        clang_total_ms("${trace}" "InstantiateClass" classes)
+        math(EXPR instantiation "${functions} + ${classes}")
+    else()
+        gcc_phase_ms("${output}" "TOTAL" total)
+        gcc_phase_ms("${output}" "template instantiation" instantiation)
+    endif()
+    set(${total_out} ${total} PARENT_SCOPE)
+    set(${instantiation_out} ${instantiation} PARENT_SCOPE)
+endfunction()
+
+# Compiles a source file REPEAT times and keeps the fastest run.
+function(profile source total_out instantiation_out)
+    set(best_total -1)
+    set(best_instantiation 0)
+    foreach(i RANGE 1 ${REPEAT})
+        compile_once("${source}" total instantiation)
+        if(best_total LESS 0 OR total LESS best_total)
+            set(best_total ${total})
+            set(best_instantiation ${instantiation})
+        endif()
+    endforeach()
+    set(${total_out} ${best_total} PARENT_SCOPE)
+    set(${instantiation_out} ${best_instantiation} PARENT_SCOPE)
+endfunction()
+
+# ---------------------------------------------------------------------------
+# driver
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+set(csv "facility,width,depth,total_ms,instantiation_ms,delta_ms\n")
+set(table "| facility | width | depth | total [ms] | instantiation [ms] | delta to baseline [ms] |\n")
+string(APPEND table "|---|---:|---:|---:|---:|---:|\n")
+set(regressions "")
+
+if(DEFINED BASELINE)
+    file(STRINGS "${BASELINE}" baseline_lines)
+endif()
+
+foreach(width IN LISTS WIDTHS)
+    foreach(depth IN LISTS DEPTHS)
+        set(dir "${WORK_DIR}/w${width}_d${depth}")
+        file(MAKE_DIRECTORY "${dir}")
+        generate_structs("${dir}/structs.hpp" ${width} ${depth})
+
+        generate_facility("${dir}/Baseline.cpp" Baseline ${width} ${depth})
+        profile("${dir}/Baseline.cpp" baseline_total baseline_instantiation)
+        message(STATUS "width ${width}, depth ${depth}: Baseline ${baseline_total} ms")
+
+        foreach(facility IN LISTS FACILITIES)
+            generate_facility("${dir}/${facility}.cpp" ${facility} ${width} ${depth})
+            profile("${dir}/${facility}.cpp" total instantiation)
+            math(EXPR delta "${total} - ${baseline_total}")
+            message(STATUS "width ${width}, depth ${depth}: ${facility} ${total} ms (+${delta} ms)")
+            string(APPEND csv "${facility},${width},${depth},${total},${instantiation},${delta}\n")
+            string(APPEND table "| ${facility} | ${width} | ${depth} | ${total} | ${instantiation} | ${delta} |\n")
+
+            foreach(line IN LISTS baseline_lines)
+                if(line MATCHES "^${facility},${width},${depth},[0-9]+,[0-9]+,(-?[0-9]+)$")
+                    math(EXPR budget "${CMAKE_MATCH_1} + (${CMAKE_MATCH_1} * ${TOLERANCE}) / 100 + 50")
+                    if(delta GREATER budget)
+                        string(APPEND regressions
+                            "  ${facility} (width ${width}, depth ${depth}): ${delta} ms, budget ${budget} ms\n")
+                    endif()
+                endif()
+            endforeach()
+        endforeach()
+    endforeach()
+endforeach()
+
+file(WRITE "${WORK_DIR}/report.csv" "${csv}")
+file(WRITE "${WORK_DIR}/report.md" "# reflection-cpp compile-time profile (${CXX_ID})\n\n${table}")
+message(STATUS "Compile-time report written to ${WORK_DIR}/report.md and ${WORK_DIR}/report.csv\n\n${table}")
+
+if(regressions)
+    message(FATAL_ERROR "CompileTimeProfile: compile-time regressions against ${BASELINE}:\n${regressions}")
+endif()
@@ -0,0 +1,650 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+/// Fixed set of worker threads executing submitted tasks in submission order.
+///
+/// Threads waiting for their tasks to complete help executing pending tasks, so that tasks may themselves
+/// submit tasks and wait for them without deadlocking the pool.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(size_t workers)
+    {
+        _workers.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            _workers.emplace_back([this] { Work(); });
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            auto const _ = std::lock_guard { _mutex };
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+    }
+
+    /// Pool shared by all algorithms not given a pool of their own, with one worker per additional hardware thread.
+    [[nodiscard]] static ThreadPool& Shared()
+    {
+        static ThreadPool pool { std::max<unsigned>(std::thread::hardware_concurrency(), 2) - 1 };
+        return pool;
+    }
+
+    /// Number of worker threads.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _workers.size();
+    }
+
+    /// Queues a task for execution on one of the workers. Tasks must not throw.
+    void Submit(std::function<void()> task)
+    {
+        {
+            auto const _ = std::lock_guard { _mutex };
+            _tasks.push_back(std::move(task));
+        }
+        _wakeup.notify_one();
+    }
+
+    /// Executes one pending task on the calling thread, if there is any.
+    bool RunPending()
+    {
+        auto task = std::function<void()> {};
+        {
+            auto const _ = std::lock_guard { _mutex };
+            if (_tasks.empty())
+                return false;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+        return true;
+    }
+
+  private:
+    void Work()
+    {
+        while (true)
+        {
+            auto task = std::function<void()> {};
+            {
+                auto lock = std::unique_lock { _mutex };
+                _wakeup.wait(lock, [&] { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::deque<std::function<void()>> _tasks;
+    bool _stopping = false;
+    std::vector<std::jthread> _workers; // last, to be joined before the members they use are destroyed
+};
+
+/// Number of threads the algorithms in this header may use. The default runs on the calling thread only.
+struct Parallelism
+{
+    size_t threads = 1;
+
+    /// Pool to run on, ThreadPool::Shared() if not set.
+    ThreadPool* pool = nullptr;
+
+    /// Uses one thread per hardware thread.
+    [[nodiscard]] static Parallelism Hardware() noexcept
+    {
+        return { .threads = std::max<size_t>(1, std::thread::hardware_concurrency()) };
+    }
+};
+
+namespace detail
+{
+    // Splits [0, count) into at most parallelism.threads contiguous chunks of at least minChunk elements,
+    // and calls f(chunk, begin, end) for each of them. The first chunk runs on the calling thread,
+    // the others on the thread pool. Returns the number of chunks.
+    //
+    // If f throws, the other chunks still run, as the tasks on the pool refer to f and to locals of this function.
+    // Once all chunks have finished, the first exception thrown is rethrown on the calling thread.
+    template <typename F>
+    size_t ForEachChunk(size_t count, Parallelism parallelism, size_t minChunk, F const& f)
+    {
+        auto const chunks = std::clamp<size_t>(count / std::max<size_t>(minChunk, 1), 1, parallelism.threads);
+        auto const bounds = [&](size_t chunk) {
+            return count * chunk / chunks;
+        };
+        if (chunks == 1)
+        {
+            f(size_t { 0 }, size_t { 0 }, count);
+            return 1;
+        }
+
+        auto failureMutex = std::mutex {};
+        auto failure = std::exception_ptr {};
+        auto const run = [&](size_t chunk) noexcept {
+            try
+            {
+                f(chunk, bounds(chunk), bounds(chunk + 1));
+            }
+            catch (...)
+            {
+                auto const _ = std::lock_guard { failureMutex };
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        };
+
+        auto& pool = parallelism.pool ? *parallelism.pool : ThreadPool::Shared();
+        auto done = std::latch { static_cast<std::ptrdiff_t>(chunks - 1) };
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            try
+            {
+                pool.Submit([&run, &done, chunk] {
+                    run(chunk);
+                    done.count_down();
+                });
+            }
+            catch (...)
+            {
+                // The task could not be queued, e.g. for lack of memory, so its chunk runs here instead.
+                run(chunk);
+                done.count_down();
+            }
+        }
+        run(0);
+        while (!done.try_wait() && pool.RunPending())
+            ;
+        done.wait();
+        if (failure)
+            std::rethrow_exception(failure);
+        return chunks;
+    }
+
+    // Members ReduceMembers computes statistics for.
+    template <typename T>
+    concept ReducibleMember = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+    // Type the values of an arithmetic type are summed up in, such that sums do not overflow as easily.
+    template <typename T>
+    using SumTypeOf = std::conditional_t<std::is_floating_point_v<T>,
+                                         std::common_type_t<T, double>,
+                                         std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+} // namespace detail
+
+/// Placeholder ReduceMembers yields for members that are not reduced, i.e. all but the arithmetic ones.
+struct NotReduced
+{
+    constexpr bool operator==(NotReduced const&) const noexcept = default;
+};
+
+/// Reduction operations for ReduceMembers.
+///
+/// Every operation provides an Accumulator<T> for each arithmetic member type T, which is default constructed,
+/// updated with every value of its member, merged with the accumulators of other chunks of the input,
+/// and finally yields its Result().
+namespace Reduce
+{
+    /// Sum of every member, as std::int64_t, std::uint64_t or double (long double for long double members).
+    struct Sum
+    {
+        template <typename T>
+        struct Accumulator
+        {
+            detail::SumTypeOf<T> total {};
+
+            constexpr void Update(T value) noexcept
+            {
+                total += value;
+            }
+
+            constexpr void Merge(Accumulator const& other) noexcept
+            {
+                total += other.total;
+            }
+
+            [[nodiscard]] constexpr detail::SumTypeOf<T> Result() const noexcept
+            {
+                return total;
+            }
+        };
+    };
+
+    /// Smallest value of every member, or std::numeric_limits<T>::max() for an empty input.
+    struct Min
+    {
+        template <typename T>
+        struct Accumulator
+        {
+            T value = std::numeric_limits<T>::max();
+
+            constexpr void Update(T other) noexcept
+            {
+                value = std::min(value, other);
+            }
+
+            constexpr void Merge(Accumulator const& other) noexcept
+            {
+                Update(other.value);
+            }
+
+            [[nodiscard]] constexpr T Result() const noexcept
+            {
+                return value;
+            }
+        };
+    };
+
+    /// Largest value of every member, or std::numeric_limits<T>::lowest() for an empty input.
+    struct Max
+    {
+        template <typename T>
+        struct Accumulator
+        {
+            T value = std::numeric_limits<T>::lowest();
+
+            constexpr void Update(T other) noexcept
+            {
+                value = std::max(value, other);
+            }
+
+            constexpr void Merge(Accumulator const& other) noexcept
+            {
+                Update(other.value);
+            }
+
+            [[nodiscard]] constexpr T Result() const noexcept
+            {
+                return value;
+            }
+        };
+    };
+
+    /// Arithmetic mean of every member as double, or NaN for an empty input.
+    struct Mean
+    {
+        template <typename T>
+        struct Accumulator
+        {
+            double total = 0;
+            size_t count = 0;
+
+            constexpr void Update(T value) noexcept
+            {
+                total += static_cast<double>(value);
+                ++count;
+            }
+
+            constexpr void Merge(Accumulator const& other) noexcept
+            {
+                total += other.total;
+                count += other.count;
+            }
+
+            [[nodiscard]] constexpr double Result() const noexcept
+            {
+                return count ? total / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+            }
+        };
+    };
+} // namespace Reduce
+
+namespace detail
+{
+    struct NotReducedAccumulator
+    {
+        constexpr void Merge(NotReducedAccumulator const&) noexcept {}
+
+        [[nodiscard]] constexpr NotReduced Result() const noexcept
+        {
+            return {};
+        }
+    };
+
+    template <typename Op, typename T>
+    struct ReduceAccumulatorOf
+    {
+        using type = NotReducedAccumulator;
+    };
+
+    template <typename Op, ReducibleMember T>
+    struct ReduceAccumulatorOf<Op, T>
+    {
+        using type = typename Op::template Accumulator<T>;
+    };
+
+    template <typename Op, typename Object, typename = std::make_index_sequence<CountMembers<Object>>>
+    struct ReduceAccumulatorsOf;
+
+    template <typename Op, typename Object, size_t... I>
+    struct ReduceAccumulatorsOf<Op, Object, std::index_sequence<I...>>
+    {
+        using type = std::tuple<typename ReduceAccumulatorOf<Op, MemberTypeOf<I, Object>>::type...>;
+    };
+
+    // Number of objects reduced into block-local accumulators before these are merged into the result.
+    // The local accumulators do not alias the objects, so that they can be kept in registers.
+    constexpr size_t ReduceBlockSize = 1024;
+
+    template <typename Object, typename Accumulators>
+    void ReduceBlocks(std::span<Object const> objects, Accumulators& accumulators)
+    {
+        for (size_t begin = 0; begin < objects.size(); begin += ReduceBlockSize)
+        {
+            auto const block = objects.subspan(begin, std::min(ReduceBlockSize, objects.size() - begin));
+            auto local = Accumulators {};
+            for (auto const& object: block)
+                EnumerateMembers<Object>([&]<size_t I, typename Member>() {
+                    if constexpr (ReducibleMember<Member>)
+                        std::get<I>(local).Update(GetMemberAt<I>(object));
+                });
+            template_for<0, CountMembers<Object>>(
+                [&]<auto I>() { std::get<I>(accumulators).Merge(std::get<I>(local)); });
+        }
+    }
+} // namespace detail
+
+/// Reduces every arithmetic member over a range of objects with the given operation, e.g. Reduce::Sum.
+///
+/// The objects are processed in blocks, updating the accumulators of all members per block,
+/// and split into chunks reduced on separate threads as permitted by parallelism.
+/// If an accumulator throws, the exception is rethrown once all chunks have finished.
+///
+/// @return a tuple with the result of the operation for every member, at the index of the member,
+///         or NotReduced for members that are not arithmetic
+template <typename Object, typename Op>
+[[nodiscard]] auto ReduceMembers(std::span<Object const> objects, Op /*op*/ = {}, Parallelism parallelism = {})
+{
+    using Accumulators = typename detail::ReduceAccumulatorsOf<Op, Object>::type;
+
+    auto partials = std::vector<Accumulators>(std::max<size_t>(parallelism.threads, 1));
+    auto const chunks = detail::ForEachChunk(
+        objects.size(), parallelism, detail::ReduceBlockSize, [&](size_t chunk, size_t begin, size_t end) {
+            detail::ReduceBlocks(objects.subspan(begin, end - begin), partials[chunk]);
+        });
+
+    auto& result = partials[0];
+    for (size_t chunk = 1; chunk < chunks; ++chunk)
+        template_for<0, CountMembers<Object>>(
+            [&]<auto I>() { std::get<I>(result).Merge(std::get<I>(partials[chunk])); });
+
+    return std::apply([](auto const&... accumulators) { return std::tuple { accumulators.Result()... }; }, result);
+}
+
+template <typename Object, typename Op>
+[[nodiscard]] auto ReduceMembers(std::vector<Object> const& objects, Op op = {}, Parallelism parallelism = {})
+{
+    return ReduceMembers(std::span<Object const> { objects }, op, parallelism);
+}
+
+namespace detail
+{
+    // Number of objects every member is transformed for in turn, small enough for a block to stay in cache.
+    constexpr size_t TransformBlockSize = 1024;
+
+    template <size_t I, typename Object, typename F>
+    void TransformMember(std::span<Object> block, F const& fn)
+    {
+        for (auto& object: block)
+        {
+            auto& member = GetMemberAt<I>(object);
+            if constexpr (requires { fn.template operator()<I>(member); })
+                fn.template operator()<I>(member);
+            else
+                fn(member);
+        }
+    }
+} // namespace detail
+
+/// Applies fn in place to the members selected by ElementMask of all objects.
+///
+/// The objects are processed in blocks, running one loop per member over the block, such that the compiler sees
+/// a plain loop over a single member that it can vectorize. As permitted by parallelism, the objects are
+/// split into chunks transformed on separate threads.
+///
+/// @param mask A std::integer_sequence of the indices of the members to transform, as for EnumerateMembers
+/// @param fn   Called with a reference to every selected member, as fn(member) or,
+///             if it takes the member index as template argument, as fn.template operator()<I>(member)
+///
+/// If fn throws, the exception is rethrown once all chunks have finished, which leaves the objects partially
+/// transformed.
+template <typename Object, typename T, T... Indices, typename F>
+void TransformMembers(std::span<Object> objects,
+                      std::integer_sequence<T, Indices...> /*mask*/,
+                      F const& fn,
+                      Parallelism parallelism = {})
+{
+    detail::ForEachChunk(objects.size(),
+                         parallelism,
+                         detail::TransformBlockSize,
+                         [&](size_t /*chunk*/, size_t begin, size_t end) {
+                             for (auto b = begin; b < end; b += detail::TransformBlockSize)
+                             {
+                                 auto const block = objects.subspan(b, std::min(detail::TransformBlockSize, end - b));
+                                 (detail::TransformMember<static_cast<size_t>(Indices)>(block, fn), ...);
+                             }
+                         });
+}
+
+template <typename Object, typename T, T... Indices, typename F>
+void TransformMembers(std::vector<Object>& objects,
+                      std::integer_sequence<T, Indices...> mask,
+                      F const& fn,
+                      Parallelism parallelism = {})
+{
+    TransformMembers(std::span<Object> { objects }, mask, fn, parallelism);
+}
+
+/// Comparator ordering objects lexicographically by the given members, e.g. LessBy<&Trade::symbol, &Trade::time>.
+template <auto... Members>
+    requires(sizeof...(Members) > 0 && (std::is_member_object_pointer_v<decltype(Members)> && ...))
+struct LessBy
+{
+    template <typename Object>
+    [[nodiscard]] constexpr bool operator()(Object const& lhs, Object const& rhs) const
+    {
+        return Less<Members...>(lhs, rhs);
+    }
+
+  private:
+    template <auto First, auto... Rest, typename Object>
+    [[nodiscard]] static constexpr bool Less(Object const& lhs, Object const& rhs)
+    {
+        auto const& a = GetMemberAt<MemberIndexOf<First>>(lhs);
+        auto const& b = GetMemberAt<MemberIndexOf<First>>(rhs);
+        if constexpr (sizeof...(Rest) == 0)
+            return a < b;
+        else
+            return a < b || (!(b < a) && Less<Rest...>(lhs, rhs));
+    }
+};
+
+namespace detail
+{
+    template <typename T>
+    concept RadixKey = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    template <size_t Size>
+    using RadixBits = std::conditional_t<
+        Size == 1,
+        std::uint8_t,
+        std::conditional_t<Size == 2, std::uint16_t, std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+    // Maps a key to an unsigned integer of the same size with the same order.
+    template <RadixKey T>
+    [[nodiscard]] constexpr auto ToRadixBits(T value) noexcept
+    {
+        using U = RadixBits<sizeof(T)>;
+        constexpr auto SignBit = U { 1 } << (sizeof(T) * 8 - 1);
+        if constexpr (std::is_enum_v<T>)
+            return ToRadixBits(static_cast<std::underlying_type_t<T>>(value));
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            // -0.0 compares equal to +0.0, so it gets the same key, and both keep their order as in a stable sort.
+            auto const bits = std::bit_cast<U>(value == T {} ? T {} : value);
+            return static_cast<U>(bits & SignBit ? ~bits : bits | SignBit);
+        }
+        else if constexpr (std::is_signed_v<T>)
+            return static_cast<U>(static_cast<U>(value) ^ SignBit);
+        else
+            return static_cast<U>(value);
+    }
+
+    template <auto... Members>
+    constexpr size_t RadixKeyBytes = (sizeof(MemberTypeOf<MemberIndexOf<Members>, MemberClassType<Members>>) + ...);
+
+    // Members can be sorted by radix if all of them are arithmetic or enums and their keys fit into 64 bits.
+    template <typename Object, auto... Members>
+    constexpr bool IsRadixSortable = [] {
+        if constexpr (!(RadixKey<MemberTypeOf<MemberIndexOf<Members>, Object>> && ...))
+            return false;
+        else
+            return RadixKeyBytes<Members...> <= 8;
+    }();
+
+    // Below this size, sorting by comparison is faster than extracting keys and permuting.
+    constexpr size_t RadixSortThreshold = 1024;
+
+    template <typename Key>
+    struct RadixItem
+    {
+        Key key;
+        std::uint32_t index;
+    };
+
+    template <typename Key, typename Bits>
+    [[nodiscard]] constexpr Key AppendRadixBits(Key key, Bits bits) noexcept
+    {
+        if constexpr (sizeof(Bits) == sizeof(Key))
+            return bits; // the only key member
+        else
+            return static_cast<Key>((key << (sizeof(Bits) * 8)) | bits);
+    }
+
+    // Concatenation of the order preserving bits of all key members, the first member in the highest bits.
+    template <typename Key, auto... Members, typename Object>
+    [[nodiscard]] constexpr Key RadixKeyOf(Object const& object) noexcept
+    {
+        Key key = 0;
+        ((key = AppendRadixBits(key, ToRadixBits(GetMemberAt<MemberIndexOf<Members>>(object)))), ...);
+        return key;
+    }
+
+    // Bits sorted by per pass: 2048 buckets, whose write positions still stay in cache while scattering.
+    constexpr size_t RadixDigitBits = 11;
+    constexpr size_t RadixBuckets = size_t { 1 } << RadixDigitBits;
+
+    // Stable least significant digit radix sort of the items by their keys, one digit per pass,
+    // skipping the passes over digits that are the same in all keys. Every pass scatters the items into the other
+    // of items and buffer; returns the one holding the sorted items.
+    template <size_t KeyBytes, typename Key>
+    std::span<RadixItem<Key>> RadixSortItems(std::span<RadixItem<Key>> items, std::span<RadixItem<Key>> buffer)
+    {
+        constexpr size_t Digits = (KeyBytes * 8 + RadixDigitBits - 1) / RadixDigitBits;
+        auto const digitOf = [](Key key, size_t digit) {
+            return static_cast<size_t>(key >> (digit * RadixDigitBits)) & (RadixBuckets - 1);
+        };
+
+        auto counts = std::vector<std::array<size_t, RadixBuckets>>(Digits);
+        for (auto const& item: items)
+            for (size_t digit = 0; digit < Digits; ++digit)
+                ++counts[digit][digitOf(item.key, digit)];
+
+        for (size_t digit = 0; digit < Digits; ++digit)
+        {
+            auto& count = counts[digit];
+            if (std::ranges::find(count, items.size()) != count.end())
+                continue;
+            size_t offset = 0;
+            for (auto& c: count)
+                offset += std::exchange(c, offset);
+            for (auto const& item: items)
+                buffer[count[digitOf(item.key, digit)]++] = item;
+            std::swap(items, buffer);
+        }
+        return items;
+    }
+
+    // Moves objects[items[i].index] to position i. The objects are gathered into a buffer first: unlike following
+    // the cycles of the permutation in place, the loads of a gather do not depend on each other and can overlap.
+    template <typename Object, typename Key>
+    void ApplyPermutation(std::span<Object> objects, std::span<RadixItem<Key> const> items)
+    {
+        auto sorted = std::vector<Object> {};
+        sorted.reserve(objects.size());
+        for (auto const& item: items)
+            sorted.push_back(std::move(objects[item.index]));
+        std::ranges::move(sorted, objects.begin());
+    }
+} // namespace detail
+
+/// Sorts objects by the given members, lexicographically and stable, e.g. SortBy<&Trade::venue, &Trade::time>(trades).
+///
+/// If all keys are arithmetic or enum members of at most 8 bytes in total, the keys are extracted into a contiguous
+/// buffer of (key, index) pairs that is radix sorted, and the objects are then moved into place once.
+/// Otherwise the objects are sorted by comparison with LessBy<Members...>. Both give the same order, where -0.0 and
+/// +0.0 are equal keys. Floating point keys must not be NaN, as NaN is not ordered by LessBy either.
+template <auto... Members, typename Object>
+    requires(sizeof...(Members) > 0 && (std::same_as<MemberClassType<Members>, Object> && ...))
+void SortBy(std::span<Object> objects)
+{
+    if constexpr (detail::IsRadixSortable<Object, Members...>)
+    {
+        if (objects.size() >= detail::RadixSortThreshold && objects.size() <= std::numeric_limits<std::uint32_t>::max())
+        {
+            constexpr auto KeyBytes = detail::RadixKeyBytes<Members...>;
+            using Key = std::conditional_t<KeyBytes <= 4, std::uint32_t, std::uint64_t>;
+            // Not value initialized, every item is written before it is read.
+            auto const storage = std::make_unique_for_overwrite<detail::RadixItem<Key>[]>(2 * objects.size());
+            auto const items = std::span { storage.get(), objects.size() };
+            for (size_t i = 0; i < objects.size(); ++i)
+                items[i] = { .key = detail::RadixKeyOf<Key, Members...>(objects[i]),
+                             .index = static_cast<std::uint32_t>(i) };
+            auto const buffer = std::span { storage.get() + objects.size(), objects.size() };
+            auto const sorted = detail::RadixSortItems<KeyBytes>(items, buffer);
+            detail::ApplyPermutation(objects, std::span<detail::RadixItem<Key> const> { sorted });
+            return;
+        }
+    }
+    std::stable_sort(objects.begin(), objects.end(), LessBy<Members...> {});
+}
+
+template <auto... Members, typename Object>
+void SortBy(std::vector<Object>& objects)
+{
+    SortBy<Members...>(std::span<Object> { objects });
+}
+
+} // namespace Reflection
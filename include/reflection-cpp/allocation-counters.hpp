@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+/// Number of allocations and allocated bytes.
+struct AllocationStats
+{
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+    constexpr AllocationStats& operator+=(AllocationStats const& other) noexcept
+    {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr AllocationStats operator-(AllocationStats const& other) const noexcept
+    {
+        return { .allocations = allocations - other.allocations, .bytes = bytes - other.bytes };
+    }
+
+    [[nodiscard]] constexpr bool operator==(AllocationStats const&) const noexcept = default;
+};
+
+namespace detail
+{
+    inline AllocationStats& ThreadAllocationStats() noexcept
+    {
+        thread_local AllocationStats stats;
+        return stats;
+    }
+} // namespace detail
+
+/// Allocations made through CountingAllocator on the calling thread since its start.
+[[nodiscard]] inline AllocationStats CurrentThreadAllocations() noexcept
+{
+    return detail::ThreadAllocationStats();
+}
+
+/// Allocator forwarding to std::allocator, counting every allocation on the calling thread.
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    constexpr CountingAllocator() noexcept = default;
+
+    template <typename U>
+    constexpr CountingAllocator(CountingAllocator<U> const& /*other*/) noexcept
+    {
+    }
+
+    [[nodiscard]] T* allocate(size_t count)
+    {
+        auto& stats = detail::ThreadAllocationStats();
+        ++stats.allocations;
+        stats.bytes += count * sizeof(T);
+        return std::allocator<T> {}.allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept
+    {
+        std::allocator<T> {}.deallocate(pointer, count);
+    }
+
+    template <typename U>
+    [[nodiscard]] constexpr bool operator==(CountingAllocator<U> const& /*other*/) const noexcept
+    {
+        return true;
+    }
+};
+
+/// Debug counters of instrumented Inspect calls, keyed by TypeNameOf of the inspected type.
+class AllocationCounters
+{
+  public:
+    struct Entry
+    {
+        size_t calls = 0;
+        AllocationStats total;
+        AllocationStats last;
+    };
+
+    /// Accounts the allocations of one call to the given type.
+    static void Record(std::string_view typeName, AllocationStats const& call)
+    {
+        auto const _ = std::lock_guard { mutex() };
+        auto& entry = entries()[typeName];
+        ++entry.calls;
+        entry.total += call;
+        entry.last = call;
+    }
+
+    [[nodiscard]] static Entry Get(std::string_view typeName)
+    {
+        auto const _ = std::lock_guard { mutex() };
+        auto const i = entries().find(typeName);
+        return i != entries().end() ? i->second : Entry {};
+    }
+
+    template <typename T>
+    [[nodiscard]] static Entry Get()
+    {
+        return Get(TypeNameOf<T>);
+    }
+
+    /// All recorded entries, ordered by type name.
+    [[nodiscard]] static std::vector<std::pair<std::string_view, Entry>> Snapshot()
+    {
+        auto const _ = std::lock_guard { mutex() };
+        return { entries().begin(), entries().end() };
+    }
+
+    static void Reset()
+    {
+        auto const _ = std::lock_guard { mutex() };
+        entries().clear();
+    }
+
+  private:
+    static std::mutex& mutex()
+    {
+        static std::mutex instance;
+        return instance;
+    }
+
+    static std::map<std::string_view, Entry>& entries()
+    {
+        static std::map<std::string_view, Entry> instance;
+        return instance;
+    }
+};
+
+/// Inspect policy allocating the result with CountingAllocator and accounting the allocations of every call
+/// to AllocationCounters, under the name of the inspected type.
+struct CountingInspectPolicy
+{
+    using allocator_type = CountingAllocator<char>;
+
+    template <typename Object>
+    struct Scope
+    {
+        AllocationStats const before = detail::ThreadAllocationStats();
+
+        Scope() = default;
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+        ~Scope()
+        {
+            AllocationCounters::Record(TypeNameOf<Object>, detail::ThreadAllocationStats() - before);
+        }
+    };
+};
+
+} // namespace Reflection
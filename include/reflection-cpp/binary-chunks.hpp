@@ -0,0 +1,527 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace Reflection
+{
+
+namespace detail
+{
+    // Recycles coroutine frames per thread in size classes, such that serializing many nested objects does not
+    // allocate once the pool has warmed up.
+    class ChunkFramePool
+    {
+      public:
+        ChunkFramePool() = default;
+        ChunkFramePool(ChunkFramePool const&) = delete;
+        ChunkFramePool& operator=(ChunkFramePool const&) = delete;
+
+        ~ChunkFramePool()
+        {
+            for (auto* block: _free)
+                while (block)
+                    ::operator delete(std::exchange(block, block->next));
+        }
+
+        [[nodiscard]] static void* Allocate(size_t size)
+        {
+            auto const sizeClass = (size + Granularity - 1) / Granularity;
+            if (sizeClass >= Classes)
+                return ::operator new(size);
+            auto& head = Instance()._free[sizeClass];
+            if (head == nullptr)
+                return ::operator new(sizeClass * Granularity);
+            return std::exchange(head, head->next);
+        }
+
+        static void Deallocate(void* pointer, size_t size) noexcept
+        {
+            auto const sizeClass = (size + Granularity - 1) / Granularity;
+            if (sizeClass >= Classes)
+                return ::operator delete(pointer);
+            auto& head = Instance()._free[sizeClass];
+            head = ::new (pointer) Block { head };
+        }
+
+      private:
+        struct Block
+        {
+            Block* next;
+        };
+
+        static constexpr size_t Granularity = 64;
+        static constexpr size_t Classes = 32;
+
+        static ChunkFramePool& Instance() noexcept
+        {
+            thread_local ChunkFramePool instance;
+            return instance;
+        }
+
+        std::array<Block*, Classes> _free {};
+    };
+
+    // Fixed capacity output buffer of SerializeChunks.
+    class ChunkWriter
+    {
+      public:
+        explicit ChunkWriter(size_t capacity):
+            _data { std::make_unique_for_overwrite<std::byte[]>(std::max<size_t>(capacity, 1)) },
+            _capacity { std::max<size_t>(capacity, 1) }
+        {
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        // Copies the bytes from offset on, as many as fit, and advances offset past them.
+        // Returns true once all bytes have been written.
+        bool WriteSome(std::span<std::byte const> bytes, size_t& offset) noexcept
+        {
+            auto const count = std::min(bytes.size() - offset, _capacity - _size);
+            std::memcpy(_data.get() + _size, bytes.data() + offset, count);
+            _size += count;
+            offset += count;
+            return offset == bytes.size();
+        }
+
+        // Writes all bytes if they fit, or none.
+        bool TryWrite(std::span<std::byte const> bytes) noexcept
+        {
+            if (bytes.size() > _capacity - _size)
+                return false;
+            std::memcpy(_data.get() + _size, bytes.data(), bytes.size());
+            _size += bytes.size();
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        // Drops the bytes written after the buffer had the given size.
+        void Rewind(size_t size) noexcept
+        {
+            _size = size;
+        }
+
+        // The buffered bytes, which remain valid until the next write.
+        [[nodiscard]] std::span<std::byte const> Flush() noexcept
+        {
+            return { _data.get(), std::exchange(_size, 0) };
+        }
+
+      private:
+        std::unique_ptr<std::byte[]> _data;
+        size_t _capacity;
+        size_t _size = 0;
+    };
+} // namespace detail
+
+/// Lazily produced chunks of serialized bytes, see SerializeChunks.
+///
+/// The coroutine serializing an object may delegate to nested coroutines by yielding them, whose chunks are passed
+/// through to the consumer without involving the outer coroutines.
+class BinaryChunks
+{
+  public:
+    class promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class promise_type
+    {
+      public:
+        BinaryChunks get_return_object() noexcept
+        {
+            return BinaryChunks { Handle::from_promise(*this) };
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        // Continues with the coroutine that delegated to this one, if any.
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept
+            {
+                auto& promise = handle.promise();
+                if (promise._parent == nullptr)
+                    return std::noop_coroutine();
+                promise._root->_leaf = promise._parent;
+                return Handle::from_promise(*promise._parent);
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(std::span<std::byte const> chunk) noexcept
+        {
+            _root->_chunk = chunk;
+            return {};
+        }
+
+        // Runs a nested coroutine until it completes, passing its chunks through.
+        class NestedAwaiter
+        {
+          public:
+            explicit NestedAwaiter(Handle nested) noexcept: _nested { nested } {}
+            NestedAwaiter(NestedAwaiter const&) = delete;
+            NestedAwaiter& operator=(NestedAwaiter const&) = delete;
+
+            ~NestedAwaiter()
+            {
+                _nested.destroy();
+            }
+
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept
+            {
+                auto& promise = _nested.promise();
+                promise._parent = &handle.promise();
+                promise._root = handle.promise()._root;
+                promise._root->_leaf = &promise;
+                return _nested;
+            }
+
+            void await_resume()
+            {
+                if (auto const exception = _nested.promise()._exception)
+                    std::rethrow_exception(exception);
+            }
+
+          private:
+            Handle _nested;
+        };
+
+        NestedAwaiter yield_value(BinaryChunks&& nested) noexcept
+        {
+            return NestedAwaiter { std::exchange(nested._handle, {}) };
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            _exception = std::current_exception();
+        }
+
+        static void* operator new(size_t size)
+        {
+            return detail::ChunkFramePool::Allocate(size);
+        }
+
+        static void operator delete(void* pointer, size_t size) noexcept
+        {
+            detail::ChunkFramePool::Deallocate(pointer, size);
+        }
+
+      private:
+        friend class BinaryChunks;
+
+        promise_type* _root = this;
+        promise_type* _parent = nullptr;
+        promise_type* _leaf = this; // the innermost running coroutine, maintained by the root only
+        std::span<std::byte const> _chunk;
+        std::exception_ptr _exception;
+    };
+
+    class iterator
+    {
+      public:
+        using value_type = std::span<std::byte const>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        [[nodiscard]] value_type operator*() const noexcept
+        {
+            return _chunks->_handle.promise()._chunk;
+        }
+
+        iterator& operator++()
+        {
+            _chunks->Resume();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        [[nodiscard]] bool operator==(std::default_sentinel_t /*end*/) const noexcept
+        {
+            return _chunks->_handle.done();
+        }
+
+      private:
+        friend class BinaryChunks;
+
+        explicit iterator(BinaryChunks* chunks) noexcept: _chunks { chunks } {}
+
+        BinaryChunks* _chunks = nullptr;
+    };
+
+    BinaryChunks(BinaryChunks&& other) noexcept: _handle { std::exchange(other._handle, {}) } {}
+
+    BinaryChunks& operator=(BinaryChunks&& other) noexcept
+    {
+        std::swap(_handle, other._handle);
+        return *this;
+    }
+
+    ~BinaryChunks()
+    {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    /// Starts producing chunks. Can be called only once.
+    [[nodiscard]] iterator begin()
+    {
+        Resume();
+        return iterator { this };
+    }
+
+    [[nodiscard]] std::default_sentinel_t end() const noexcept
+    {
+        return {};
+    }
+
+  private:
+    explicit BinaryChunks(Handle handle) noexcept: _handle { handle } {}
+
+    void Resume()
+    {
+        auto& root = _handle.promise();
+        Handle::from_promise(*root._leaf).resume();
+        if (_handle.done() && root._exception)
+            std::rethrow_exception(root._exception);
+    }
+
+    Handle _handle;
+};
+
+namespace detail
+{
+    // Values that are written inline by the coroutine of the enclosing vector or aggregate.
+    template <typename T>
+    concept ChunkLeaf = BinaryScalar<T> || BinaryStringLike<T>;
+
+    // Writes the binary representation of a leaf from offset on, as far as the writer has space.
+    template <ChunkLeaf T>
+    bool WriteLeafSome(ChunkWriter& writer, T const& value, size_t& offset) noexcept
+    {
+        if constexpr (BinaryScalar<T>)
+        {
+            auto const bits = ToWireBits(value);
+            return writer.WriteSome(std::as_bytes(std::span { &bits, 1 }), offset);
+        }
+        else
+        {
+            auto const text = std::string_view(value);
+            auto const length = ToWireBits(static_cast<BinaryLength>(text.size()));
+            if (offset < sizeof(length) && !writer.WriteSome(std::as_bytes(std::span { &length, 1 }), offset))
+                return false;
+            auto textOffset = offset - sizeof(length);
+            auto const done = writer.WriteSome(std::as_bytes(std::span { text }), textOffset);
+            offset = sizeof(length) + textOffset;
+            return done;
+        }
+    }
+
+    template <typename T>
+    bool TryWriteAll(ChunkWriter& writer, T const& value) noexcept
+    {
+        if constexpr (BinaryScalar<T>)
+        {
+            auto const bits = ToWireBits(value);
+            return writer.TryWrite(std::as_bytes(std::span { &bits, 1 }));
+        }
+        else if constexpr (BinaryStringLike<T>)
+        {
+            auto const text = std::string_view(value);
+            return TryWriteAll(writer, static_cast<BinaryLength>(text.size()))
+                   && writer.TryWrite(std::as_bytes(std::span { text }));
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            if (!TryWriteAll(writer, static_cast<BinaryLength>(value.size())))
+                return false;
+            return std::ranges::all_of(value, [&](auto const& element) { return TryWriteAll(writer, element); });
+        }
+        else
+        {
+            auto written = true;
+            CallOnMembersWithoutName(value, [&]<size_t I, typename M>(M const& member) {
+                written = written && TryWriteAll(writer, member);
+            });
+            return written;
+        }
+    }
+
+    // Writes a whole value without suspending if it fits into the rest of the chunk, which is the common case for
+    // values much smaller than a chunk. Otherwise nothing is written.
+    template <typename T>
+    bool WriteWhole(ChunkWriter& writer, T const& value) noexcept
+    {
+        auto const size = writer.size();
+        if (TryWriteAll(writer, value))
+            return true;
+        writer.Rewind(size);
+        return false;
+    }
+
+    template <typename T>
+    BinaryChunks WriteChunks(ChunkWriter& writer, T const& value);
+
+    // Per member steps of the coroutine of an aggregate: leaves are written by the aggregate's coroutine itself,
+    // all other members are written whole or else delegated to a nested coroutine.
+    template <typename T>
+    struct ChunkSteps
+    {
+        using Leaf = bool (*)(ChunkWriter&, T const&, size_t&);
+        using Whole = bool (*)(ChunkWriter&, T const&);
+        using Nested = BinaryChunks (*)(ChunkWriter&, T const&);
+
+        static constexpr size_t MemberCount = CountMembers<T>;
+
+        static constexpr auto leaves = [] {
+            auto result = std::array<Leaf, MemberCount> {};
+            EnumerateMembers<T>([&]<size_t I, typename M>() {
+                if constexpr (ChunkLeaf<std::remove_cvref_t<M>>)
+                    result[I] = +[](ChunkWriter& writer, T const& object, size_t& offset) {
+                        return WriteLeafSome(writer, GetMemberAt<I>(object), offset);
+                    };
+            });
+            return result;
+        }();
+
+        static constexpr auto wholes = [] {
+            auto result = std::array<Whole, MemberCount> {};
+            EnumerateMembers<T>([&]<size_t I, typename M>() {
+                if constexpr (!ChunkLeaf<std::remove_cvref_t<M>>)
+                    result[I] = +[](ChunkWriter& writer, T const& object) {
+                        return WriteWhole(writer, GetMemberAt<I>(object));
+                    };
+            });
+            return result;
+        }();
+
+        static constexpr auto nested = [] {
+            auto result = std::array<Nested, MemberCount> {};
+            EnumerateMembers<T>([&]<size_t I, typename M>() {
+                if constexpr (!ChunkLeaf<std::remove_cvref_t<M>>)
+                    result[I] = +[](ChunkWriter& writer, T const& object) {
+                        return WriteChunks(writer, GetMemberAt<I>(object));
+                    };
+            });
+            return result;
+        }();
+    };
+
+    template <typename T>
+    BinaryChunks WriteChunks(ChunkWriter& writer, T const& value)
+    {
+        if constexpr (BinaryVector<T>)
+        {
+            using Element = typename T::value_type;
+            for (size_t offset = 0; !WriteLeafSome(writer, static_cast<BinaryLength>(value.size()), offset);)
+                co_yield writer.Flush();
+            for (auto const& element: value)
+            {
+                if constexpr (ChunkLeaf<Element>)
+                {
+                    for (size_t offset = 0; !WriteLeafSome(writer, element, offset);)
+                        co_yield writer.Flush();
+                }
+                else if (!WriteWhole(writer, element))
+                    co_yield WriteChunks(writer, element);
+            }
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be encoded in the binary format");
+            using Steps = ChunkSteps<T>;
+            for (size_t i = 0; i < Steps::MemberCount; ++i)
+            {
+                if (auto const leaf = Steps::leaves[i])
+                {
+                    for (size_t offset = 0; !leaf(writer, value, offset);)
+                        co_yield writer.Flush();
+                }
+                else if (!Steps::wholes[i](writer, value))
+                    co_yield Steps::nested[i](writer, value);
+            }
+        }
+    }
+
+    template <typename Object>
+    BinaryChunks SerializeChunks(Object const& object, size_t chunkSize)
+    {
+        auto writer = ChunkWriter { chunkSize };
+        if constexpr (ChunkLeaf<Object>)
+        {
+            for (size_t offset = 0; !WriteLeafSome(writer, object, offset);)
+                co_yield writer.Flush();
+        }
+        else if (!WriteWhole(writer, object))
+            co_yield WriteChunks(writer, object);
+        if (!writer.empty())
+            co_yield writer.Flush();
+    }
+} // namespace detail
+
+/// Serializes an object in the layout of SerializeBinary incrementally, as chunks of at most chunkSize bytes.
+///
+/// Serialization suspends whenever a chunk is full and resumes where it left off in the traversal of the members
+/// once the consumer asks for the next chunk, so that output can be interleaved with I/O in bounded memory:
+///
+///     for (auto const chunk: SerializeChunks(portfolio, 64 * 1024))
+///         socket.Send(chunk);
+///
+/// Each chunk is a view into a buffer owned by the returned object, valid until the next chunk is requested.
+/// All chunks but the last one are exactly chunkSize bytes. The object must neither change nor go away until the
+/// chunks have been consumed.
+template <typename Object>
+[[nodiscard]] BinaryChunks SerializeChunks(Object const& object, size_t chunkSize)
+{
+    return detail::SerializeChunks(object, chunkSize);
+}
+
+} // namespace Reflection
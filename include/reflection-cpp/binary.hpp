@@ -0,0 +1,854 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+/// Type used to encode string lengths, element counts and payload sizes in the binary formats.
+using BinaryLength = std::uint32_t;
+
+namespace detail
+{
+    template <typename T>
+    struct IsBinaryString: std::false_type
+    {
+    };
+
+    template <typename Traits, typename Allocator>
+    struct IsBinaryString<std::basic_string<char, Traits, Allocator>>: std::true_type
+    {
+    };
+
+    template <typename T>
+    struct IsBinaryVector: std::false_type
+    {
+    };
+
+    template <typename T, typename Allocator>
+    struct IsBinaryVector<std::vector<T, Allocator>>: std::true_type
+    {
+    };
+
+    // Arithmetic and enum values are stored with their object representation in little endian byte order.
+    template <typename T>
+    concept BinaryScalar = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                           && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    // Anything that can be viewed as a string can be written, but only owning strings can be read back.
+    template <typename T>
+    concept BinaryStringLike = !BinaryScalar<T> && std::is_convertible_v<T const&, std::string_view>;
+
+    template <typename T>
+    concept BinaryString = IsBinaryString<T>::value;
+
+    template <typename T>
+    concept BinaryVector = IsBinaryVector<T>::value;
+
+    // Containers allocating from a std::pmr::memory_resource, which is fixed when the container is constructed.
+    template <typename T>
+    concept PmrContainer =
+        requires { typename T::allocator_type; }
+        && std::same_as<typename T::allocator_type, std::pmr::polymorphic_allocator<typename T::value_type>>;
+
+    // Re-creates a pmr container as an empty one allocating from resource, unless it already does or resource is
+    // null. Assignment cannot be used, as it never changes the allocator of a pmr container.
+    template <typename T>
+    void AdoptMemoryResource(T& value, std::pmr::memory_resource* resource) noexcept
+    {
+        if constexpr (PmrContainer<T>)
+        {
+            if (resource && value.get_allocator().resource() != resource)
+            {
+                std::destroy_at(&value);
+                std::construct_at(&value, typename T::allocator_type { resource });
+            }
+        }
+    }
+
+    template <size_t Size>
+    struct UnsignedOfSize;
+
+    template <>
+    struct UnsignedOfSize<1>
+    {
+        using type = std::uint8_t;
+    };
+
+    template <>
+    struct UnsignedOfSize<2>
+    {
+        using type = std::uint16_t;
+    };
+
+    template <>
+    struct UnsignedOfSize<4>
+    {
+        using type = std::uint32_t;
+    };
+
+    template <>
+    struct UnsignedOfSize<8>
+    {
+        using type = std::uint64_t;
+    };
+
+    template <typename U>
+    [[nodiscard]] constexpr U ToLittleEndian(U value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little || sizeof(U) == 1)
+            return value;
+        else
+        {
+            U result = 0;
+            for (size_t i = 0; i < sizeof(U); ++i)
+            {
+                result = static_cast<U>((result << 8) | (value & 0xFF));
+                value = static_cast<U>(value >> 8);
+            }
+            return result;
+        }
+    }
+
+    inline void AppendBytes(std::vector<std::byte>& output, void const* data, size_t size)
+    {
+        auto const* bytes = static_cast<std::byte const*>(data);
+        output.insert(output.end(), bytes, bytes + size);
+    }
+
+    template <BinaryScalar T>
+    [[nodiscard]] auto ToWireBits(T value) noexcept
+    {
+        using U = typename UnsignedOfSize<sizeof(T)>::type;
+        if constexpr (std::is_same_v<T, bool>)
+            return ToLittleEndian(static_cast<U>(value ? 1 : 0));
+        else
+            return ToLittleEndian(std::bit_cast<U>(value));
+    }
+
+    template <BinaryScalar T>
+    void AppendScalar(std::vector<std::byte>& output, T value)
+    {
+        auto const bits = ToWireBits(value);
+        AppendBytes(output, &bits, sizeof(bits));
+    }
+
+    // Overwrites a previously reserved scalar, used to back-patch length prefixes.
+    template <BinaryScalar T>
+    void StoreScalarAt(std::vector<std::byte>& output, size_t offset, T value) noexcept
+    {
+        auto const bits = ToWireBits(value);
+        std::memcpy(output.data() + offset, &bits, sizeof(bits));
+    }
+} // namespace detail
+
+/// Sequential reader over a binary input buffer.
+///
+/// All read operations fail by returning false instead of reading past the end of the input.
+class BinaryReader
+{
+  public:
+    constexpr explicit BinaryReader(std::span<std::byte const> input) noexcept: _input { input } {}
+
+    /// Number of bytes not yet consumed.
+    [[nodiscard]] constexpr size_t remaining() const noexcept
+    {
+        return _input.size();
+    }
+
+    /// The bytes not yet consumed.
+    [[nodiscard]] constexpr std::span<std::byte const> rest() const noexcept
+    {
+        return _input;
+    }
+
+    [[nodiscard]] constexpr bool Skip(size_t count) noexcept
+    {
+        if (count > _input.size())
+            return false;
+        _input = _input.subspan(count);
+        return true;
+    }
+
+    /// Consumes the next count bytes and returns a view onto them in bytes.
+    [[nodiscard]] constexpr bool Take(size_t count, std::span<std::byte const>& bytes) noexcept
+    {
+        if (count > _input.size())
+            return false;
+        bytes = _input.first(count);
+        _input = _input.subspan(count);
+        return true;
+    }
+
+    template <detail::BinaryScalar T>
+    [[nodiscard]] bool Read(T& value) noexcept
+    {
+        using U = typename detail::UnsignedOfSize<sizeof(T)>::type;
+        if (_input.size() < sizeof(U))
+            return false;
+        U bits {};
+        std::memcpy(&bits, _input.data(), sizeof(U));
+        _input = _input.subspan(sizeof(U));
+        bits = detail::ToLittleEndian(bits);
+        if constexpr (std::is_same_v<T, bool>)
+            value = bits != 0;
+        else
+            value = std::bit_cast<T>(bits);
+        return true;
+    }
+
+    /// Reads an unsigned LEB128 varint of at most 10 bytes.
+    ///
+    /// @return false if the input is truncated or the varint does not fit into 64 bits
+    [[nodiscard]] bool ReadVarint(std::uint64_t& value) noexcept
+    {
+        if (!_input.empty() && std::to_integer<std::uint8_t>(_input[0]) < 0x80)
+        {
+            value = std::to_integer<std::uint64_t>(_input[0]);
+            _input = _input.subspan(1);
+            return true;
+        }
+        if (_input.size() >= sizeof(std::uint64_t))
+        {
+            // Fast path for varints of up to 8 bytes: locate the last byte, whose continuation bit is clear,
+            // in a single load, then pack the 7 bit groups of the bytes before it without branching.
+            std::uint64_t word {};
+            std::memcpy(&word, _input.data(), sizeof(word));
+            word = detail::ToLittleEndian(word);
+            auto const ends = ~word & 0x8080'8080'8080'8080ull;
+            if (ends != 0)
+            {
+                auto const length = static_cast<size_t>(std::countr_zero(ends) / 8 + 1);
+                auto bits = word & (~std::uint64_t { 0 } >> (64 - 8 * length)) & 0x7F7F'7F7F'7F7F'7F7Full;
+                bits = ((bits & 0x7F00'7F00'7F00'7F00ull) >> 1) | (bits & 0x007F'007F'007F'007Full);
+                bits = ((bits & 0x3FFF'0000'3FFF'0000ull) >> 2) | (bits & 0x0000'3FFF'0000'3FFFull);
+                bits = ((bits & 0x0FFF'FFFF'0000'0000ull) >> 4) | (bits & 0x0000'0000'0FFF'FFFFull);
+                value = bits;
+                _input = _input.subspan(length);
+                return true;
+            }
+        }
+        std::uint64_t result = 0;
+        for (size_t i = 0; i < 10 && i < _input.size(); ++i)
+        {
+            auto const byte = std::to_integer<std::uint64_t>(_input[i]);
+            // The 10th byte only holds the highest bit.
+            if (i == 9 && byte > 1)
+                return false;
+            result |= (byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0)
+            {
+                value = result;
+                _input = _input.subspan(i + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::span<std::byte const> _input;
+};
+
+// ---------------------------------------------------------------------------
+// Fixed layout: members are written in declaration order without any framing.
+
+namespace detail
+{
+    template <typename T>
+    void WriteBinaryValue(std::vector<std::byte>& output, T const& value)
+    {
+        if constexpr (BinaryScalar<T>)
+            AppendScalar(output, value);
+        else if constexpr (BinaryStringLike<T>)
+        {
+            auto const text = std::string_view(value);
+            AppendScalar(output, static_cast<BinaryLength>(text.size()));
+            AppendBytes(output, text.data(), text.size());
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            AppendScalar(output, static_cast<BinaryLength>(value.size()));
+            for (auto const& element: value)
+                WriteBinaryValue(output, element);
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be encoded in the binary format");
+            EnumerateMembers(value, [&]<size_t I>(auto const& member) { WriteBinaryValue(output, member); });
+        }
+    }
+
+    template <BinaryString T>
+    [[nodiscard]] bool ReadBinaryString(BinaryReader& reader, T& value)
+    {
+        BinaryLength length {};
+        std::span<std::byte const> bytes;
+        if (!reader.Read(length) || !reader.Take(length, bytes))
+            return false;
+        value.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        return true;
+    }
+
+    // A non-null resource is adopted by every pmr string and vector on the way down, see AdoptMemoryResource.
+    template <typename T>
+    [[nodiscard]] bool ReadBinaryValue(BinaryReader& reader, T& value, std::pmr::memory_resource* resource = nullptr)
+    {
+        if constexpr (BinaryScalar<T>)
+            return reader.Read(value);
+        else if constexpr (BinaryString<T>)
+        {
+            AdoptMemoryResource(value, resource);
+            return ReadBinaryString(reader, value);
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            BinaryLength count {};
+            if (!reader.Read(count))
+                return false;
+            AdoptMemoryResource(value, resource);
+            value.clear();
+            // Do not trust the count for preallocation beyond what the input could possibly hold.
+            value.reserve(std::min<size_t>(count, reader.remaining()));
+            for (BinaryLength i = 0; i < count; ++i)
+                if (!ReadBinaryValue(reader, value.emplace_back(), resource))
+                    return false;
+            return true;
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be decoded from the binary format");
+            bool ok = true;
+            EnumerateMembers(value,
+                             [&]<size_t I>(auto& member) { ok = ok && ReadBinaryValue(reader, member, resource); });
+            return ok;
+        }
+    }
+} // namespace detail
+
+/// Appends the fixed layout binary representation of an object to output.
+///
+/// Arithmetic and enum members are stored in little endian byte order, strings and vectors are prefixed with their
+/// length, and nested aggregates are stored inline. The layout carries no schema information,
+/// so reader and writer must agree on the exact type.
+template <typename Object>
+void SerializeBinary(Object const& object, std::vector<std::byte>& output)
+{
+    detail::WriteBinaryValue(output, object);
+}
+
+/// Decodes an object previously written with SerializeBinary, consuming its bytes from the reader.
+///
+/// @return false if the input is truncated
+template <typename Object>
+[[nodiscard]] bool DeserializeBinary(BinaryReader& reader, Object& object)
+{
+    return detail::ReadBinaryValue(reader, object);
+}
+
+template <typename Object>
+[[nodiscard]] bool DeserializeBinary(std::span<std::byte const> input, Object& object)
+{
+    auto reader = BinaryReader { input };
+    return DeserializeBinary(reader, object);
+}
+
+/// Decodes an object previously written with SerializeBinary, allocating its std::pmr strings and vectors,
+/// at any nesting depth, from resource.
+///
+/// Members using other allocators, such as std::string, are decoded as usual.
+///
+/// @return false if the input is truncated
+template <typename Object>
+[[nodiscard]] bool DeserializeBinary(BinaryReader& reader, Object& object, std::pmr::memory_resource* resource)
+{
+    return detail::ReadBinaryValue(reader, object, resource);
+}
+
+/// Decodes consecutive objects previously written with SerializeBinary until the input is exhausted, appending them
+/// to objects.
+///
+/// The objects and all their std::pmr strings and vectors are allocated from the memory resource of objects, e.g. a
+/// std::pmr::monotonic_buffer_resource per batch, such that the whole batch is freed at once by releasing it.
+///
+/// @return false if the input is truncated, in which case objects holds the objects decoded so far
+template <typename Object>
+[[nodiscard]] bool DeserializeBinaryBatch(std::span<std::byte const> input, std::pmr::vector<Object>& objects)
+{
+    auto* const resource = objects.get_allocator().resource();
+    auto reader = BinaryReader { input };
+    while (reader.remaining() > 0)
+    {
+        if (!DeserializeBinary(reader, objects.emplace_back(), resource))
+        {
+            objects.pop_back();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Tagged layout: every member is prefixed with a key made of a tag hashed from its name and its wire type,
+// such that readers can match fields by name and skip unknown ones.
+
+/// Wire type of a field in the tagged binary format, stored in the lowest 3 bits of the field key.
+enum class WireType : std::uint8_t
+{
+    Fixed8,
+    Fixed16,
+    Fixed32,
+    Fixed64,
+    Sized, // BinaryLength prefixed payload
+};
+
+namespace detail
+{
+    constexpr std::uint32_t WireTypeBits = 3;
+    constexpr std::uint32_t TagMask = 0xFFFF'FFFFu >> WireTypeBits;
+
+    [[nodiscard]] constexpr std::uint32_t Fnv1a(std::string_view text) noexcept
+    {
+        std::uint32_t hash = 2166136261u;
+        for (char const c: text)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    constexpr WireType WireTypeOf = [] {
+        if constexpr (BinaryScalar<T>)
+            return static_cast<WireType>(std::countr_zero(sizeof(T)));
+        else
+            return WireType::Sized;
+    }();
+
+    [[nodiscard]] constexpr std::uint32_t FieldKey(std::uint32_t tag, WireType wireType) noexcept
+    {
+        return (tag << WireTypeBits) | static_cast<std::uint32_t>(wireType);
+    }
+} // namespace detail
+
+/// Tag of the member at index I of Object in the tagged binary format.
+///
+/// The tag only depends on the member's name, so it is stable across reordering and insertion of other members.
+template <size_t I, typename Object>
+constexpr std::uint32_t MemberTagOf = detail::Fnv1a(MemberNameOf<I, Object>) & detail::TagMask;
+
+namespace detail
+{
+    template <typename T>
+    void WriteTaggedValue(std::vector<std::byte>& output, T const& value);
+
+    template <typename T>
+    [[nodiscard]] bool ReadTaggedValue(BinaryReader& reader, T& value, std::pmr::memory_resource* resource);
+
+    // Precomputed lookup from field tags to member indices (open addressing, linear probing)
+    // and the decoder of every member.
+    template <typename Object>
+    struct TaggedSchema
+    {
+        using Decoder = bool (*)(BinaryReader&, Object&, std::pmr::memory_resource*);
+
+        static constexpr size_t MemberCount = CountMembers<Object>;
+        static constexpr size_t TableSize = std::bit_ceil(MemberCount * 2 + 1);
+        static constexpr std::uint16_t EmptySlot = 0xFFFF;
+
+        static constexpr auto tags = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<std::uint32_t, MemberCount> { MemberTagOf<I, Object>... };
+        }(std::make_index_sequence<MemberCount> {});
+
+        static constexpr auto wireTypes = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<WireType, MemberCount> { WireTypeOf<MemberTypeOf<I, Object>>... };
+        }(std::make_index_sequence<MemberCount> {});
+
+        static constexpr auto decoders = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<Decoder, MemberCount> {
+                +[](BinaryReader& reader, Object& object, std::pmr::memory_resource* resource) {
+                    return ReadTaggedValue(reader, GetMemberAt<I>(object), resource);
+                }...
+            };
+        }(std::make_index_sequence<MemberCount> {});
+
+        static constexpr auto slots = [] {
+            auto result = std::array<std::uint16_t, TableSize> {};
+            result.fill(EmptySlot);
+            for (size_t i = 0; i < MemberCount; ++i)
+            {
+                auto slot = tags[i] & (TableSize - 1);
+                while (result[slot] != EmptySlot)
+                    slot = (slot + 1) & (TableSize - 1);
+                result[slot] = static_cast<std::uint16_t>(i);
+            }
+            return result;
+        }();
+
+        static constexpr bool HasUniqueTags = [] {
+            for (size_t i = 0; i < MemberCount; ++i)
+                for (size_t j = i + 1; j < MemberCount; ++j)
+                    if (tags[i] == tags[j])
+                        return false;
+            return true;
+        }();
+        static_assert(HasUniqueTags, "Member name hashes collide, please rename one of the members");
+
+        /// @return the member index of the given tag, or MemberCount if the tag is unknown
+        [[nodiscard]] static constexpr size_t Find(std::uint32_t tag) noexcept
+        {
+            for (auto slot = tag & (TableSize - 1);; slot = (slot + 1) & (TableSize - 1))
+            {
+                auto const index = slots[slot];
+                if (index == EmptySlot)
+                    return MemberCount;
+                if (tags[index] == tag)
+                    return index;
+            }
+        }
+    };
+
+    template <typename T>
+    void WriteTaggedValue(std::vector<std::byte>& output, T const& value)
+    {
+        if constexpr (BinaryScalar<T> || BinaryStringLike<T>)
+            WriteBinaryValue(output, value);
+        else
+        {
+            auto const lengthOffset = output.size();
+            AppendScalar(output, BinaryLength { 0 });
+            if constexpr (BinaryVector<T>)
+            {
+                AppendScalar(output, static_cast<BinaryLength>(value.size()));
+                for (auto const& element: value)
+                    WriteTaggedValue(output, element);
+            }
+            else
+            {
+                static_assert(std::is_aggregate_v<T>, "Type cannot be encoded in the tagged binary format");
+                EnumerateMembers(value, [&]<size_t I, typename M>(M const& member) {
+                    AppendScalar(output, FieldKey(MemberTagOf<I, T>, WireTypeOf<std::remove_cvref_t<M>>));
+                    WriteTaggedValue(output, member);
+                });
+            }
+            auto const length = output.size() - lengthOffset - sizeof(BinaryLength);
+            StoreScalarAt(output, lengthOffset, static_cast<BinaryLength>(length));
+        }
+    }
+
+    [[nodiscard]] inline bool SkipTaggedValue(BinaryReader& reader, WireType wireType) noexcept
+    {
+        switch (wireType)
+        {
+            case WireType::Fixed8: return reader.Skip(1);
+            case WireType::Fixed16: return reader.Skip(2);
+            case WireType::Fixed32: return reader.Skip(4);
+            case WireType::Fixed64: return reader.Skip(8);
+            case WireType::Sized: {
+                BinaryLength length {};
+                return reader.Read(length) && reader.Skip(length);
+            }
+        }
+        return false;
+    }
+
+    template <typename Object>
+    [[nodiscard]] bool ReadTaggedFields(BinaryReader& reader, Object& object, std::pmr::memory_resource* resource)
+    {
+        using Schema = TaggedSchema<Object>;
+        while (reader.remaining() > 0)
+        {
+            std::uint32_t key {};
+            if (!reader.Read(key))
+                return false;
+            auto const wireType = static_cast<WireType>(key & ((1u << WireTypeBits) - 1));
+            auto const index = Schema::Find(key >> WireTypeBits);
+            if (index < Schema::MemberCount && Schema::wireTypes[index] == wireType)
+            {
+                if (!Schema::decoders[index](reader, object, resource))
+                    return false;
+            }
+            else if (!SkipTaggedValue(reader, wireType))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool ReadTaggedValue(BinaryReader& reader, T& value, std::pmr::memory_resource* resource)
+    {
+        if constexpr (BinaryScalar<T>)
+            return reader.Read(value);
+        else if constexpr (BinaryString<T>)
+        {
+            AdoptMemoryResource(value, resource);
+            return ReadBinaryString(reader, value);
+        }
+        else
+        {
+            BinaryLength length {};
+            std::span<std::byte const> payload;
+            if (!reader.Read(length) || !reader.Take(length, payload))
+                return false;
+            auto inner = BinaryReader { payload };
+            if constexpr (BinaryVector<T>)
+            {
+                BinaryLength count {};
+                if (!inner.Read(count))
+                    return false;
+                AdoptMemoryResource(value, resource);
+                value.clear();
+                value.reserve(std::min<size_t>(count, inner.remaining()));
+                for (BinaryLength i = 0; i < count; ++i)
+                    if (!ReadTaggedValue(inner, value.emplace_back(), resource))
+                        return false;
+                return true;
+            }
+            else
+            {
+                static_assert(std::is_aggregate_v<T>, "Type cannot be decoded from the tagged binary format");
+                return ReadTaggedFields(inner, value, resource);
+            }
+        }
+    }
+} // namespace detail
+
+/// Appends the tagged binary representation of an object to output.
+///
+/// Each member is written as a key (the member's name hash and its wire type) followed by its value,
+/// and every aggregate and vector is prefixed with its byte length.
+/// This allows readers with an older or newer version of the type to match members by name and skip unknown ones.
+template <typename Object>
+void SerializeTagged(Object const& object, std::vector<std::byte>& output)
+{
+    detail::WriteTaggedValue(output, object);
+}
+
+/// Decodes an object previously written with SerializeTagged, possibly from a different version of the type.
+///
+/// Fields are matched to members by their tag. Unknown fields, or fields whose wire type changed, are skipped,
+/// and members that are not present in the input keep their current value.
+///
+/// @return false if the input is truncated or malformed
+template <typename Object>
+[[nodiscard]] bool DeserializeTagged(BinaryReader& reader, Object& object)
+{
+    return detail::ReadTaggedValue(reader, object, nullptr);
+}
+
+template <typename Object>
+[[nodiscard]] bool DeserializeTagged(std::span<std::byte const> input, Object& object)
+{
+    auto reader = BinaryReader { input };
+    return DeserializeTagged(reader, object);
+}
+
+/// Decodes an object previously written with SerializeTagged, allocating the std::pmr strings and vectors it decodes,
+/// at any nesting depth, from resource. Members not present in the input keep their current value and allocator.
+template <typename Object>
+[[nodiscard]] bool DeserializeTagged(BinaryReader& reader, Object& object, std::pmr::memory_resource* resource)
+{
+    return detail::ReadTaggedValue(reader, object, resource);
+}
+
+// ---------------------------------------------------------------------------
+// Compact layout: the fixed layout with integers stored as LEB128 varints, so that small values take fewer bytes.
+
+namespace detail
+{
+    inline void AppendVarint(std::vector<std::byte>& output, std::uint64_t value)
+    {
+        if (value < 0x80)
+        {
+            output.push_back(static_cast<std::byte>(value));
+            return;
+        }
+        std::array<std::byte, 10> bytes;
+        size_t length = 0;
+        while (value >= 0x80)
+        {
+            bytes[length++] = static_cast<std::byte>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[length++] = static_cast<std::byte>(value);
+        AppendBytes(output, bytes.data(), length);
+    }
+
+    // Maps signed values of small magnitude to small unsigned values: 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+    [[nodiscard]] constexpr std::uint64_t ZigZagEncode(std::int64_t value) noexcept
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    [[nodiscard]] constexpr std::int64_t ZigZagDecode(std::uint64_t value) noexcept
+    {
+        return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    // Integral types and enums, which are stored as (zigzag encoded, if signed) varints.
+    template <typename T>
+    concept CompactInteger = std::is_integral_v<T> || std::is_enum_v<T>;
+
+    template <CompactInteger T>
+    [[nodiscard]] std::uint64_t ToVarintBits(T value) noexcept
+    {
+        if constexpr (std::is_enum_v<T>)
+            return ToVarintBits(static_cast<std::underlying_type_t<T>>(value));
+        else if constexpr (std::is_signed_v<T>)
+            return ZigZagEncode(value);
+        else
+            return value;
+    }
+
+    template <CompactInteger T>
+    [[nodiscard]] bool FromVarintBits(std::uint64_t bits, T& value) noexcept
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            std::underlying_type_t<T> underlying {};
+            if (!FromVarintBits(bits, underlying))
+                return false;
+            value = static_cast<T>(underlying);
+            return true;
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            value = bits != 0;
+            return bits <= 1;
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            auto const decoded = ZigZagDecode(bits);
+            value = static_cast<T>(decoded);
+            if constexpr (sizeof(T) < sizeof(decoded))
+                return decoded >= std::numeric_limits<T>::min() && decoded <= std::numeric_limits<T>::max();
+            return true;
+        }
+        else
+        {
+            value = static_cast<T>(bits);
+            if constexpr (sizeof(T) < sizeof(bits))
+                return bits <= std::numeric_limits<T>::max();
+            return true;
+        }
+    }
+
+    template <typename T>
+    void WriteCompactValue(std::vector<std::byte>& output, T const& value)
+    {
+        if constexpr (CompactInteger<T>)
+            AppendVarint(output, ToVarintBits(value));
+        else if constexpr (BinaryScalar<T>)
+            AppendScalar(output, value);
+        else if constexpr (BinaryStringLike<T>)
+        {
+            auto const text = std::string_view(value);
+            AppendVarint(output, text.size());
+            AppendBytes(output, text.data(), text.size());
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            AppendVarint(output, value.size());
+            for (auto const& element: value)
+                WriteCompactValue(output, element);
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be encoded in the compact binary format");
+            EnumerateMembers(value, [&]<size_t I>(auto const& member) {
+                WriteCompactValue<MemberTypeOf<I, T>>(output, member);
+            });
+        }
+    }
+
+    template <typename T>
+    [[nodiscard]] bool ReadCompactValue(BinaryReader& reader, T& value)
+    {
+        if constexpr (CompactInteger<T>)
+        {
+            std::uint64_t bits {};
+            return reader.ReadVarint(bits) && FromVarintBits(bits, value);
+        }
+        else if constexpr (BinaryScalar<T>)
+            return reader.Read(value);
+        else if constexpr (BinaryString<T>)
+        {
+            std::uint64_t length {};
+            std::span<std::byte const> bytes;
+            if (!reader.ReadVarint(length) || !reader.Take(length, bytes))
+                return false;
+            value.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            return true;
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            std::uint64_t count {};
+            if (!reader.ReadVarint(count))
+                return false;
+            value.clear();
+            // Do not trust the count for preallocation beyond what the input could possibly hold.
+            value.reserve(std::min<size_t>(count, reader.remaining()));
+            for (std::uint64_t i = 0; i < count; ++i)
+                if (!ReadCompactValue(reader, value.emplace_back()))
+                    return false;
+            return true;
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be decoded from the compact binary format");
+            bool ok = true;
+            EnumerateMembers(value, [&]<size_t I>(auto& member) {
+                ok = ok && ReadCompactValue<MemberTypeOf<I, T>>(reader, member);
+            });
+            return ok;
+        }
+    }
+} // namespace detail
+
+/// Appends the compact binary representation of an object to output.
+///
+/// The layout is the one of SerializeBinary, except that integral members are stored as LEB128 varints (zigzag
+/// encoded if signed), enums as varints of their underlying value, and string lengths and element counts as varints.
+/// Floating point members are stored as they are. Small values thus take a single byte instead of up to eight.
+template <typename Object>
+void SerializeCompact(Object const& object, std::vector<std::byte>& output)
+{
+    detail::WriteCompactValue(output, object);
+}
+
+/// Decodes an object previously written with SerializeCompact, consuming its bytes from the reader.
+///
+/// @return false if the input is truncated or holds a value out of the range of its member
+template <typename Object>
+[[nodiscard]] bool DeserializeCompact(BinaryReader& reader, Object& object)
+{
+    return detail::ReadCompactValue(reader, object);
+}
+
+template <typename Object>
+[[nodiscard]] bool DeserializeCompact(std::span<std::byte const> input, Object& object)
+{
+    auto reader = BinaryReader { input };
+    return DeserializeCompact(reader, object);
+}
+
+} // namespace Reflection
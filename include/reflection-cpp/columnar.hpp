@@ -0,0 +1,594 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Reflection
+{
+
+// ---------------------------------------------------------------------------
+// Columnar file layout: a header describing the type, followed by row groups and a footer locating them.
+//
+// The header and the footer are written in the little endian binary format. The header holds the magic, the version,
+// the byte order of the column data, TypeNameOf the stored type and, for every member, its name, its kind and its
+// element size. Rows are stored in row groups of a bounded number of rows, so that a writer never buffers more than
+// one group, and every row group holds one column per member. The footer holds, for every row group, its number of
+// rows and the location of each of its columns, and the file ends with the offset of the footer.
+// Columns are stored in native byte order, aligned to ColumnAlignment bytes, so that a memory mapped file can be
+// read in place: fixed-width columns are plain arrays of the member values, string columns are an array of
+// row count + 1 offsets into a blob holding all string contents of the row group back to back.
+
+namespace detail
+{
+    enum class ColumnKind : std::uint8_t
+    {
+        Fixed,
+        String,
+    };
+
+    constexpr auto ColumnFileMagic = std::array { 'R', 'F', 'L', 'C', 'O', 'L', 'S', '\0' };
+    constexpr std::uint32_t ColumnFileVersion = 2;
+    constexpr size_t ColumnAlignment = 64;
+
+    template <typename T>
+    constexpr ColumnKind ColumnKindOf = [] {
+        if constexpr (BinaryScalar<T>)
+            return ColumnKind::Fixed;
+        else
+        {
+            static_assert(BinaryStringLike<T>, "Only arithmetic, enum and string members can be stored in columns");
+            return ColumnKind::String;
+        }
+    }();
+
+    template <typename T>
+    constexpr std::uint32_t ColumnElementSize = ColumnKindOf<T> == ColumnKind::Fixed ? sizeof(T) : 0;
+
+    [[nodiscard]] constexpr size_t AlignColumn(size_t offset) noexcept
+    {
+        return (offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+    }
+
+    // Location of a column within the file.
+    struct ColumnLocation
+    {
+        std::uint64_t data = 0;       // values, or string offsets
+        std::uint64_t blob = 0;       // string contents
+        std::uint64_t blobSize = 0;
+    };
+
+    template <typename Object>
+    using ColumnLocations = std::array<ColumnLocation, CountMembers<Object>>;
+
+    // A row group: a run of consecutive rows, stored as one column per member.
+    template <typename Object>
+    struct ColumnRowGroup
+    {
+        std::uint64_t firstRow = 0; // not stored, the sum of the rows of all preceding groups
+        std::uint64_t rows = 0;
+        ColumnLocations<Object> columns {};
+    };
+
+    template <typename Object>
+    void WriteColumnHeader(std::vector<std::byte>& output)
+    {
+        AppendBytes(output, ColumnFileMagic.data(), ColumnFileMagic.size());
+        AppendScalar(output, ColumnFileVersion);
+        AppendScalar(output, static_cast<std::uint8_t>(std::endian::native == std::endian::little));
+        WriteBinaryValue(output, TypeNameOf<Object>);
+        AppendScalar(output, static_cast<BinaryLength>(CountMembers<Object>));
+        template_for<0, CountMembers<Object>>([&]<auto I>() {
+            using Member = MemberTypeOf<I, Object>;
+            WriteBinaryValue(output, MemberNameOf<I, Object>);
+            AppendScalar(output, ColumnKindOf<Member>);
+            AppendScalar(output, ColumnElementSize<Member>);
+        });
+    }
+
+    template <typename Object>
+    [[nodiscard]] bool ReadColumnHeader(BinaryReader& reader)
+    {
+        auto const expectString = [&](std::string_view expected) {
+            BinaryLength length {};
+            std::span<std::byte const> bytes;
+            return reader.Read(length) && reader.Take(length, bytes)
+                   && std::string_view(reinterpret_cast<char const*>(bytes.data()), bytes.size()) == expected;
+        };
+
+        std::span<std::byte const> magic;
+        std::uint32_t version {};
+        std::uint8_t littleEndian {};
+        BinaryLength memberCount {};
+        if (!reader.Take(ColumnFileMagic.size(), magic)
+            || std::memcmp(magic.data(), ColumnFileMagic.data(), ColumnFileMagic.size()) != 0
+            || !reader.Read(version) || version != ColumnFileVersion || !reader.Read(littleEndian)
+            || (littleEndian != 0) != (std::endian::native == std::endian::little)
+            || !expectString(TypeNameOf<Object>) || !reader.Read(memberCount) || memberCount != CountMembers<Object>)
+            return false;
+
+        bool ok = true;
+        template_for<0, CountMembers<Object>>([&]<auto I>() {
+            using Member = MemberTypeOf<I, Object>;
+            ColumnKind kind {};
+            std::uint32_t elementSize {};
+            ok = ok && expectString(MemberNameOf<I, Object>) && reader.Read(kind) && kind == ColumnKindOf<Member>
+                 && reader.Read(elementSize) && elementSize == ColumnElementSize<Member>;
+        });
+        return ok;
+    }
+
+    template <typename Object>
+    void WriteColumnFooter(std::vector<std::byte>& output,
+                           std::span<ColumnRowGroup<Object> const> groups,
+                           std::uint64_t footerOffset)
+    {
+        AppendScalar(output, static_cast<std::uint64_t>(groups.size()));
+        for (auto const& group: groups)
+        {
+            AppendScalar(output, group.rows);
+            for (auto const& column: group.columns)
+            {
+                AppendScalar(output, column.data);
+                AppendScalar(output, column.blob);
+                AppendScalar(output, column.blobSize);
+            }
+        }
+        AppendScalar(output, footerOffset);
+    }
+
+    // Reads the footer at the end of file; the row groups are not validated against the file yet.
+    template <typename Object>
+    [[nodiscard]] bool ReadColumnFooter(std::span<std::byte const> file, std::vector<ColumnRowGroup<Object>>& groups)
+    {
+        constexpr auto TrailerSize = sizeof(std::uint64_t);
+        constexpr auto GroupSize = sizeof(std::uint64_t) * (1 + 3 * CountMembers<Object>);
+
+        std::uint64_t footerOffset {};
+        if (file.size() < TrailerSize || !BinaryReader { file.last(TrailerSize) }.Read(footerOffset)
+            || footerOffset > file.size() - TrailerSize)
+            return false;
+
+        auto const footerBegin = static_cast<size_t>(footerOffset);
+        auto reader = BinaryReader { file.subspan(footerBegin, file.size() - TrailerSize - footerBegin) };
+        std::uint64_t count {};
+        if (!reader.Read(count) || count != reader.remaining() / GroupSize || reader.remaining() % GroupSize != 0)
+            return false;
+
+        groups.resize(static_cast<size_t>(count));
+        std::uint64_t firstRow = 0;
+        for (auto& group: groups)
+        {
+            group.firstRow = firstRow;
+            if (!reader.Read(group.rows))
+                return false;
+            for (auto& column: group.columns)
+                if (!reader.Read(column.data) || !reader.Read(column.blob) || !reader.Read(column.blobSize))
+                    return false;
+            firstRow += group.rows;
+        }
+        return true;
+    }
+
+    // Read-only memory mapping of a whole file.
+    class MappedFile
+    {
+      public:
+        MappedFile() = default;
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept: _data { std::exchange(other._data, {}) } {}
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                _data = std::exchange(other._data, {});
+            }
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            Close();
+        }
+
+        [[nodiscard]] std::span<std::byte const> data() const noexcept
+        {
+            return _data;
+        }
+
+        [[nodiscard]] bool Open(std::filesystem::path const& path)
+        {
+            Close();
+#if defined(_WIN32)
+            auto const file = CreateFileW(path.c_str(),
+                                          GENERIC_READ,
+                                          FILE_SHARE_READ,
+                                          nullptr,
+                                          OPEN_EXISTING,
+                                          FILE_ATTRIBUTE_NORMAL,
+                                          nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+            LARGE_INTEGER size {};
+            auto const mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+                                     ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                                     : nullptr;
+            CloseHandle(file);
+            if (!mapping)
+                return false;
+            auto const* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            if (!view)
+                return false;
+            _data = { static_cast<std::byte const*>(view), static_cast<size_t>(size.QuadPart) };
+#else
+            auto const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (file < 0)
+                return false;
+            struct stat status {};
+            void* view = MAP_FAILED;
+            if (::fstat(file, &status) == 0 && status.st_size > 0)
+                view = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+            ::close(file);
+            if (view == MAP_FAILED)
+                return false;
+            _data = { static_cast<std::byte const*>(view), static_cast<size_t>(status.st_size) };
+#endif
+            return true;
+        }
+
+        void Close() noexcept
+        {
+            if (_data.empty())
+                return;
+#if defined(_WIN32)
+            UnmapViewOfFile(_data.data());
+#else
+            ::munmap(const_cast<std::byte*>(_data.data()), _data.size());
+#endif
+            _data = {};
+        }
+
+      private:
+        std::span<std::byte const> _data;
+    };
+} // namespace detail
+
+/// View onto a string column of a ColumnReader.
+class StringColumn
+{
+  public:
+    constexpr StringColumn() noexcept = default;
+
+    constexpr StringColumn(std::span<std::uint64_t const> offsets, std::string_view blob) noexcept:
+        _offsets { offsets }, _blob { blob }
+    {
+    }
+
+    [[nodiscard]] constexpr size_t size() const noexcept
+    {
+        return _offsets.empty() ? 0 : _offsets.size() - 1;
+    }
+
+    /// The string of the given row; offsets of a corrupted file are clamped to the blob instead of trusted.
+    [[nodiscard]] constexpr std::string_view operator[](size_t row) const noexcept
+    {
+        auto const end = std::min<std::uint64_t>(_offsets[row + 1], _blob.size());
+        auto const begin = std::min<std::uint64_t>(_offsets[row], end);
+        return _blob.substr(static_cast<size_t>(begin), static_cast<size_t>(end - begin));
+    }
+
+    /// All string contents back to back.
+    [[nodiscard]] constexpr std::string_view blob() const noexcept
+    {
+        return _blob;
+    }
+
+  private:
+    std::span<std::uint64_t const> _offsets;
+    std::string_view _blob;
+};
+
+/// Writes rows of an aggregate column by column to a columnar file, to be read by ColumnReader.
+///
+/// Rows are buffered and written in row groups of at most rowGroupRows rows each, so that any number of rows can be
+/// streamed to a file while only one row group is held in memory:
+///
+///     auto writer = ColumnWriter<Trade> {};
+///     if (!writer.Open(path))
+///         return false;
+///     for (auto const& trade: trades)
+///         writer.Append(trade);
+///     return writer.Close();
+///
+/// Members must be arithmetic, enums or strings. A writer that is destroyed while open is closed, ignoring errors.
+template <typename Object>
+class ColumnWriter
+{
+  public:
+    static constexpr size_t DefaultRowGroupRows = 64 * 1024;
+
+    ColumnWriter() = default;
+    ColumnWriter(ColumnWriter const&) = delete;
+    ColumnWriter& operator=(ColumnWriter const&) = delete;
+
+    ~ColumnWriter()
+    {
+        if (_file.is_open())
+            std::ignore = Close();
+    }
+
+    /// Creates the file at path, replacing it, and writes its header. An open writer is closed first.
+    ///
+    /// @return false if the file could not be created
+    [[nodiscard]] bool Open(std::filesystem::path const& path, size_t rowGroupRows = DefaultRowGroupRows)
+    {
+        if (_file.is_open())
+            std::ignore = Close();
+        _file.open(path, std::ios::binary | std::ios::trunc);
+        _rowGroupRows = std::max<size_t>(rowGroupRows, 1);
+        _groupRows = 0;
+        _rows = 0;
+        _written = 0;
+
+        auto header = std::vector<std::byte> {};
+        detail::WriteColumnHeader<Object>(header);
+        Write(header.data(), header.size());
+        return _file.good();
+    }
+
+    /// Appends a row, and writes the current row group once it holds rowGroupRows rows.
+    void Append(Object const& row)
+    {
+        template_for<0, MemberCount>([&]<auto I>() {
+            using Member = MemberTypeOf<I, Object>;
+            auto const& value = GetMemberAt<I>(row);
+            if constexpr (detail::ColumnKindOf<Member> == detail::ColumnKind::Fixed)
+                detail::AppendBytes(_data[I], std::addressof(value), sizeof(Member));
+            else
+            {
+                auto const text = std::string_view(value);
+                detail::AppendBytes(_data[I], text.data(), text.size());
+                _offsets[I].push_back(_data[I].size());
+            }
+        });
+        ++_rows;
+        if (++_groupRows == _rowGroupRows)
+            WriteRowGroup();
+    }
+
+    void Append(std::span<Object const> rows)
+    {
+        for (auto const& row: rows)
+            Append(row);
+    }
+
+    /// Number of rows appended since Open.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _rows;
+    }
+
+    /// Writes the buffered rows and the footer, and closes the file.
+    ///
+    /// @return false if the file is not open or could not be written
+    [[nodiscard]] bool Close()
+    {
+        if (!_file.is_open())
+            return false;
+        WriteRowGroup();
+        auto footer = std::vector<std::byte> {};
+        detail::WriteColumnFooter<Object>(footer, _groups, _written);
+        Write(footer.data(), footer.size());
+        _file.close();
+        _groups.clear();
+        return _file.good();
+    }
+
+  private:
+    static constexpr size_t MemberCount = CountMembers<Object>;
+
+    void Write(void const* data, size_t size)
+    {
+        _file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+        _written += size;
+    }
+
+    void Pad()
+    {
+        static constexpr auto zeros = std::array<char, detail::ColumnAlignment> {};
+        Write(zeros.data(), detail::AlignColumn(static_cast<size_t>(_written)) - static_cast<size_t>(_written));
+    }
+
+    void WriteRowGroup()
+    {
+        if (_groupRows == 0)
+            return;
+        auto& group = _groups.emplace_back();
+        group.firstRow = _rows - _groupRows;
+        group.rows = _groupRows;
+        template_for<0, MemberCount>([&]<auto I>() {
+            Pad();
+            group.columns[I].data = _written;
+            if constexpr (detail::ColumnKindOf<MemberTypeOf<I, Object>> == detail::ColumnKind::String)
+            {
+                static constexpr std::uint64_t first = 0;
+                Write(&first, sizeof(first));
+                Write(_offsets[I].data(), _offsets[I].size() * sizeof(std::uint64_t));
+                group.columns[I].blob = _written;
+                group.columns[I].blobSize = _data[I].size();
+                _offsets[I].clear();
+            }
+            Write(_data[I].data(), _data[I].size());
+            _data[I].clear();
+        });
+        Pad();
+        _groupRows = 0;
+    }
+
+    std::ofstream _file;
+    size_t _rowGroupRows = DefaultRowGroupRows;
+    std::array<std::vector<std::byte>, MemberCount> _data;       // values, or string contents of the row group
+    std::array<std::vector<std::uint64_t>, MemberCount> _offsets; // end offsets of the strings of the row group
+    std::vector<detail::ColumnRowGroup<Object>> _groups;          // row groups written so far
+    size_t _groupRows = 0;
+    size_t _rows = 0;
+    std::uint64_t _written = 0;
+};
+
+/// Memory maps a columnar file written by ColumnWriter and exposes its columns in place, without copying.
+///
+/// The rows are split into row groups, and every column is exposed per row group: fixed-width columns as spans of
+/// the member type, string columns as StringColumn. Only the pages of the columns actually accessed are read from
+/// disk:
+///
+///     for (size_t group = 0; group < reader.rowGroups(); ++group)
+///         for (auto const price: reader.Column<&Trade::price>(group))
+///             total += price;
+template <typename Object>
+class ColumnReader
+{
+  public:
+    /// Maps the file at path, and verifies that it holds rows of Object with the same members.
+    ///
+    /// @return false if the file cannot be mapped or does not match Object
+    [[nodiscard]] bool Open(std::filesystem::path const& path)
+    {
+        Close();
+        if (!_file.Open(path))
+            return false;
+
+        auto const bytes = _file.data();
+        auto reader = BinaryReader { bytes };
+        if (!detail::ReadColumnHeader<Object>(reader) || !detail::ReadColumnFooter<Object>(bytes, _groups)
+            || !ValidateRowGroups(bytes.size()))
+        {
+            Close();
+            return false;
+        }
+        _rows = _groups.empty() ? 0 : static_cast<size_t>(_groups.back().firstRow + _groups.back().rows);
+        return true;
+    }
+
+    void Close() noexcept
+    {
+        _file.Close();
+        _groups.clear();
+        _rows = 0;
+    }
+
+    /// Number of rows in the file.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _rows;
+    }
+
+    /// Number of row groups in the file.
+    [[nodiscard]] size_t rowGroups() const noexcept
+    {
+        return _groups.size();
+    }
+
+    /// The column of the member at index I within the given row group.
+    template <size_t I>
+    [[nodiscard]] auto Column(size_t group) const noexcept
+    {
+        using Member = MemberTypeOf<I, Object>;
+        auto const* base = _file.data().data();
+        auto const& location = _groups[group].columns[I];
+        auto const rows = static_cast<size_t>(_groups[group].rows);
+        if constexpr (detail::ColumnKindOf<Member> == detail::ColumnKind::Fixed)
+            return std::span { reinterpret_cast<Member const*>(base + location.data), rows };
+        else
+            return StringColumn {
+                std::span { reinterpret_cast<std::uint64_t const*>(base + location.data), rows + 1 },
+                std::string_view { reinterpret_cast<char const*>(base + location.blob), location.blobSize }
+            };
+    }
+
+    /// The column of the given member within the given row group, e.g. Column<&Trade::price>(0).
+    template <auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+    [[nodiscard]] auto Column(size_t group) const noexcept
+    {
+        return Column<MemberIndexOf<Member>>(group);
+    }
+
+    /// Assembles the given row from all columns.
+    void ReadRow(size_t row, Object& object) const
+    {
+        // The last row group starting at or before row; empty groups share their first row with the next one.
+        auto const next = std::ranges::upper_bound(
+            _groups, std::uint64_t { row }, std::less {}, &detail::ColumnRowGroup<Object>::firstRow);
+        auto const group = static_cast<size_t>(next - _groups.begin()) - 1;
+        auto const index = row - static_cast<size_t>(_groups[group].firstRow);
+        template_for<0, CountMembers<Object>>([&]<auto I>() { GetMemberAt<I>(object) = Column<I>(group)[index]; });
+    }
+
+  private:
+    [[nodiscard]] bool ValidateRowGroups(size_t fileSize) const noexcept
+    {
+        auto const fits = [&](std::uint64_t offset, std::uint64_t size) {
+            return offset <= fileSize && size <= fileSize - offset;
+        };
+        bool ok = true;
+        for (auto const& group: _groups)
+        {
+            if (group.rows > fileSize)
+                return false;
+            template_for<0, CountMembers<Object>>([&]<auto I>() {
+                using Member = MemberTypeOf<I, Object>;
+                auto const& column = group.columns[I];
+                if constexpr (detail::ColumnKindOf<Member> == detail::ColumnKind::Fixed)
+                    ok = ok && column.data % alignof(Member) == 0 && fits(column.data, group.rows * sizeof(Member));
+                else
+                    ok = ok && column.data % alignof(std::uint64_t) == 0
+                         && fits(column.data, (group.rows + 1) * sizeof(std::uint64_t))
+                         && fits(column.blob, column.blobSize);
+            });
+        }
+        return ok;
+    }
+
+    detail::MappedFile _file;
+    std::vector<detail::ColumnRowGroup<Object>> _groups;
+    size_t _rows = 0;
+};
+
+} // namespace Reflection
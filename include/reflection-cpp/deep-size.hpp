@@ -0,0 +1,341 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <array>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Reflection
+{
+
+namespace detail
+{
+    template <typename T>
+    concept FootprintString =
+        std::same_as<T, std::basic_string<typename T::value_type, typename T::traits_type, typename T::allocator_type>>;
+
+    template <typename T>
+    concept FootprintVector = std::same_as<T, std::vector<typename T::value_type, typename T::allocator_type>>;
+
+    template <typename T>
+    constexpr bool IsStdArray = false;
+
+    template <typename T, size_t N>
+    constexpr bool IsStdArray<std::array<T, N>> = true;
+
+    template <typename T>
+    constexpr bool IsUniquePtr = false;
+
+    template <typename T, typename Deleter>
+    constexpr bool IsUniquePtr<std::unique_ptr<T, Deleter>> = !std::is_array_v<T>;
+
+    template <typename T>
+    constexpr bool IsSharedPtr = false;
+
+    template <typename T>
+    constexpr bool IsSharedPtr<std::shared_ptr<T>> = !std::is_array_v<T>;
+
+    // Smart pointers to arrays, whose length is not known.
+    template <typename T>
+    constexpr bool IsArrayPtr = false;
+
+    template <typename T, typename Deleter>
+    constexpr bool IsArrayPtr<std::unique_ptr<T, Deleter>> = std::is_array_v<T>;
+
+    template <typename T>
+    constexpr bool IsArrayPtr<std::shared_ptr<T>> = std::is_array_v<T>;
+
+    // Bookkeeping of a node of a node based container in pointers, next to its value, as in libstdc++ and libc++:
+    // the links of lists, parent, children and color of trees, and next pointer and cached hash of hash tables.
+    // Zero for other types.
+    template <typename T>
+    constexpr size_t NodeLinks = 0;
+
+    template <typename V, typename A>
+    constexpr size_t NodeLinks<std::list<V, A>> = 2;
+
+    template <typename V, typename A>
+    constexpr size_t NodeLinks<std::forward_list<V, A>> = 1;
+
+    template <typename K, typename V, typename C, typename A>
+    constexpr size_t NodeLinks<std::map<K, V, C, A>> = 4;
+
+    template <typename K, typename V, typename C, typename A>
+    constexpr size_t NodeLinks<std::multimap<K, V, C, A>> = 4;
+
+    template <typename K, typename C, typename A>
+    constexpr size_t NodeLinks<std::set<K, C, A>> = 4;
+
+    template <typename K, typename C, typename A>
+    constexpr size_t NodeLinks<std::multiset<K, C, A>> = 4;
+
+    template <typename K, typename V, typename H, typename E, typename A>
+    constexpr size_t NodeLinks<std::unordered_map<K, V, H, E, A>> = 2;
+
+    template <typename K, typename V, typename H, typename E, typename A>
+    constexpr size_t NodeLinks<std::unordered_multimap<K, V, H, E, A>> = 2;
+
+    template <typename K, typename H, typename E, typename A>
+    constexpr size_t NodeLinks<std::unordered_set<K, H, E, A>> = 2;
+
+    template <typename K, typename H, typename E, typename A>
+    constexpr size_t NodeLinks<std::unordered_multiset<K, H, E, A>> = 2;
+
+    [[nodiscard]] constexpr size_t AlignUp(size_t size, size_t alignment) noexcept
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    // Estimated size of the allocation of one node holding a Value after Links pointers.
+    template <typename Value, size_t Links>
+    constexpr size_t NodeSizeOf = AlignUp(AlignUp(Links * sizeof(void*), alignof(Value)) + sizeof(Value),
+                                          std::max(alignof(Value), alignof(void*)));
+
+    template <typename T>
+    constexpr bool IsDeque = false;
+
+    template <typename T, typename A>
+    constexpr bool IsDeque<std::deque<T, A>> = true;
+
+    // Elements per block of a std::deque, as in libstdc++, which allocates blocks of 512 bytes.
+    template <typename T>
+    constexpr size_t DequeBlockElements = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+
+    // Estimated reference counts and deleter of a std::shared_ptr, allocated along with the object by make_shared.
+    constexpr size_t SharedControlBlockSize = 2 * sizeof(void*);
+
+    // Whether a value of T may own heap memory, such that its footprint can exceed sizeof(T).
+    // Values of other types than the ones handled by HeapSizeOf are accounted for with sizeof only, but allocator
+    // aware containers and container adaptors HeapSizeOf does not know are rejected, rather than counted as empty.
+    template <typename T>
+    constexpr bool MayOwnHeap = [] {
+        if constexpr (FootprintString<T> || FootprintVector<T> || IsUniquePtr<T> || IsSharedPtr<T>
+                      || NodeLinks<T> > 0 || IsDeque<T>)
+            return true;
+        else if constexpr (IsStdArray<T> || IsOptional<T>)
+            return MayOwnHeap<typename T::value_type>;
+        else if constexpr (IsVariant<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (MayOwnHeap<std::remove_cv_t<std::variant_alternative_t<I, T>>> || ...);
+            }(std::make_index_sequence<std::variant_size_v<T>> {});
+        else if constexpr (InspectTupleLike<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (MayOwnHeap<std::remove_cv_t<std::tuple_element_t<I, T>>> || ...);
+            }(std::make_index_sequence<std::tuple_size_v<T>> {});
+        else if constexpr (std::is_aggregate_v<T> && std::is_class_v<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (MayOwnHeap<MemberTypeOf<I, T>> || ...);
+            }(std::make_index_sequence<CountMembers<T>> {});
+        else
+        {
+            static_assert(!requires { typename T::allocator_type; } && !requires { typename T::container_type; }
+                              && !IsArrayPtr<T>,
+                          "The heap memory owned by values of this type cannot be accounted for");
+            return false;
+        }
+    }();
+} // namespace detail
+
+/// Heap memory owned by a value, not counting sizeof the value itself.
+///
+/// Strings count their capacity unless their characters are stored inline (small string optimization), vectors count
+/// their capacity and the heap memory of their elements, and std::unique_ptr counts the pointee. A std::shared_ptr
+/// counts its share of the pointee and the control block, divided evenly among all its owners, so that the owners
+/// sum up to the memory they share.
+/// Smart pointers count sizeof their element_type: a std::unique_ptr<Base> owning a larger derived object counts
+/// sizeof(Base) only, and the heap memory of the object as far as it is visible through Base.
+/// Node based containers (lists, std::map, std::set and the unordered ones) count an estimated node size per element,
+/// plus the bucket array of hash tables, and std::deque counts an estimate of its blocks, after libstdc++ and libc++.
+/// Aggregates, std::array, std::optional, std::pair and std::tuple sum up their parts, std::variant counts its held
+/// alternative.
+/// Other types are assumed to own no heap memory; other containers are rejected at compile time.
+/// The bookkeeping overhead of the allocator is not included.
+template <typename T>
+[[nodiscard]] size_t HeapSizeOf(T const& value) noexcept
+{
+    if constexpr (!detail::MayOwnHeap<T>)
+        return 0;
+    else if constexpr (detail::FootprintString<T>)
+    {
+        auto const* const self = reinterpret_cast<std::byte const*>(std::addressof(value));
+        auto const* const data = reinterpret_cast<std::byte const*>(value.data());
+        if (data >= self && data < self + sizeof(T))
+            return 0;
+        return (value.capacity() + 1) * sizeof(typename T::value_type);
+    }
+    else if constexpr (detail::FootprintVector<T>)
+    {
+        using Element = typename T::value_type;
+        if constexpr (std::is_same_v<Element, bool>)
+            return (value.capacity() + CHAR_BIT - 1) / CHAR_BIT;
+        else
+        {
+            auto total = value.capacity() * sizeof(Element);
+            if constexpr (detail::MayOwnHeap<Element>)
+                for (auto const& element: value)
+                    total += HeapSizeOf(element);
+            return total;
+        }
+    }
+    else if constexpr (detail::NodeLinks<T> > 0 || detail::IsDeque<T>)
+    {
+        using Element = typename T::value_type;
+        auto const count = static_cast<size_t>(std::ranges::distance(value));
+        size_t total = 0;
+        if constexpr (detail::IsDeque<T>)
+        {
+            constexpr auto BlockElements = detail::DequeBlockElements<Element>;
+            auto const blocks = count / BlockElements + 1;
+            total = blocks * BlockElements * sizeof(Element) + std::max<size_t>(8, blocks + 2) * sizeof(void*);
+        }
+        else
+        {
+            total = count * detail::NodeSizeOf<Element, detail::NodeLinks<T>>;
+            if constexpr (requires { value.bucket_count(); })
+                total += value.bucket_count() * sizeof(void*);
+        }
+        if constexpr (detail::MayOwnHeap<std::remove_cv_t<Element>>)
+            for (auto const& element: value)
+                total += HeapSizeOf(element);
+        return total;
+    }
+    else if constexpr (detail::IsUniquePtr<T>)
+        return value ? sizeof(typename T::element_type) + HeapSizeOf(*value) : 0;
+    else if constexpr (detail::IsSharedPtr<T>)
+    {
+        if (!value)
+            return 0;
+        auto const shared = detail::SharedControlBlockSize + sizeof(typename T::element_type) + HeapSizeOf(*value);
+        return shared / static_cast<size_t>(std::max(value.use_count(), 1L));
+    }
+    else if constexpr (detail::IsOptional<T>)
+        return value ? HeapSizeOf(*value) : 0;
+    else if constexpr (detail::IsVariant<T>)
+    {
+        if (value.valueless_by_exception())
+            return 0;
+        return std::visit([](auto const& alternative) { return HeapSizeOf(alternative); }, value);
+    }
+    else if constexpr (detail::IsStdArray<T>)
+    {
+        size_t total = 0;
+        for (auto const& element: value)
+            total += HeapSizeOf(element);
+        return total;
+    }
+    else if constexpr (detail::InspectTupleLike<T>)
+        return std::apply([](auto const&... parts) { return (HeapSizeOf(parts) + ... + size_t { 0 }); }, value);
+    else
+    {
+        size_t total = 0;
+        CallOnMembersWithoutName(value, [&]<size_t I, typename M>(M const& member) { total += HeapSizeOf(member); });
+        return total;
+    }
+}
+
+/// Memory footprint of an object: sizeof the object plus all heap memory it owns, see HeapSizeOf.
+template <typename T>
+[[nodiscard]] size_t DeepSizeOf(T const& object) noexcept
+{
+    return sizeof(T) + HeapSizeOf(object);
+}
+
+/// Memory footprint of many objects, e.g. the records of a cache, not counting the storage of the span.
+///
+/// Objects of types that cannot own heap memory are accounted for without visiting them.
+template <typename T, size_t Extent>
+[[nodiscard]] size_t DeepSizeOf(std::span<T, Extent> objects) noexcept
+{
+    auto total = objects.size_bytes();
+    if constexpr (detail::MayOwnHeap<std::remove_const_t<T>>)
+        for (auto const& object: objects)
+            total += HeapSizeOf(object);
+    return total;
+}
+
+/// Footprint of one member, summed over all objects of a FootprintReport.
+struct MemberFootprint
+{
+    std::string_view name;
+    size_t inlineBytes = 0;
+    size_t heapBytes = 0;
+};
+
+/// Per member breakdown of the footprint of objects of type T, in declaration order of MemberNames<T>.
+template <typename T>
+struct FootprintReport
+{
+    size_t objects = 0;
+    /// Bytes of the objects not occupied by any member, such as padding.
+    size_t paddingBytes = 0;
+    std::array<MemberFootprint, CountMembers<T>> members {};
+
+    /// Total footprint of all objects, equal to their DeepSizeOf.
+    [[nodiscard]] size_t total() const noexcept
+    {
+        auto result = paddingBytes;
+        for (auto const& member: members)
+            result += member.inlineBytes + member.heapBytes;
+        return result;
+    }
+};
+
+/// Breaks the footprint of many objects down by member, e.g. to find the members that dominate the memory of a cache.
+///
+/// The report can be printed with Inspect.
+template <typename T, size_t Extent>
+[[nodiscard]] auto DeepSizeReport(std::span<T, Extent> objects) noexcept
+{
+    using Object = std::remove_const_t<T>;
+    auto report = FootprintReport<Object> { .objects = objects.size() };
+    size_t memberBytes = 0;
+    EnumerateMembers<Object>([&]<size_t I, typename M>() {
+        report.members[I].name = MemberNameOf<I, Object>;
+        report.members[I].inlineBytes = sizeof(M) * objects.size();
+        memberBytes += sizeof(M);
+    });
+    report.paddingBytes = (sizeof(Object) - memberBytes) * objects.size();
+    if constexpr (detail::MayOwnHeap<Object>)
+        for (auto const& object: objects)
+            CallOnMembersWithoutName(object, [&]<size_t I, typename M>(M const& member) {
+                if constexpr (detail::MayOwnHeap<std::remove_cvref_t<M>>)
+                    report.members[I].heapBytes += HeapSizeOf(member);
+            });
+    return report;
+}
+
+template <typename T>
+[[nodiscard]] FootprintReport<T> DeepSizeReport(std::vector<T> const& objects) noexcept
+{
+    return DeepSizeReport(std::span { objects });
+}
+
+template <typename T>
+    requires std::is_aggregate_v<T>
+[[nodiscard]] FootprintReport<T> DeepSizeReport(T const& object) noexcept
+{
+    return DeepSizeReport(std::span { &object, 1 });
+}
+
+} // namespace Reflection
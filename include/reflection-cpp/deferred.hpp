@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Reflection
+{
+
+/// How Deferred captures an object when it is pushed into a DeferredLog.
+enum class DeferredCapture : std::uint8_t
+{
+    /// The object representation is copied, for trivially copyable objects without pointers or views.
+    Bytes,
+    /// The members are copied in the binary layout of SerializeBinary, for objects with strings or vectors.
+    Encoded,
+    /// Only the address is captured, the object must outlive the formatting of the record.
+    Reference,
+};
+
+/// Handle to an object to be formatted later by a DeferredLog, created by Deferred.
+template <typename Object, DeferredCapture Capture>
+struct DeferredObject
+{
+    Object const* object;
+};
+
+namespace detail
+{
+    // Whether the object representation of T holds all of its value, such that a bytewise copy can be formatted after
+    // the original went away. Pointers and trivially copyable ranges such as std::string_view or std::span refer to
+    // memory elsewhere, and class types that cannot be looked into are not trusted either.
+    template <typename T>
+    constexpr bool DeferredSelfContained = [] {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+            return true;
+        else if constexpr (std::is_array_v<T>)
+            return DeferredSelfContained<std::remove_all_extents_t<T>>;
+        else if constexpr (!std::is_trivially_copyable_v<T> || !std::is_class_v<T>)
+            return false;
+        else if constexpr (IsOptional<T>)
+            return DeferredSelfContained<typename T::value_type>;
+        else if constexpr (IsVariant<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (DeferredSelfContained<std::variant_alternative_t<I, T>> && ...);
+            }(std::make_index_sequence<std::variant_size_v<T>> {});
+        else if constexpr (InspectTupleLike<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (DeferredSelfContained<std::tuple_element_t<I, T>> && ...);
+            }(std::make_index_sequence<std::tuple_size_v<T>> {});
+        else if constexpr (std::ranges::range<T>)
+            return false;
+        else if constexpr (std::is_aggregate_v<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (DeferredSelfContained<std::remove_cv_t<MemberTypeOf<I, T>>> && ...);
+            }(std::make_index_sequence<CountMembers<T>> {});
+        else
+            return false;
+    }();
+
+    // Whether T can be encoded with SerializeBinary and decoded back into a T.
+    template <typename T>
+    constexpr bool DeferredEncodable = [] {
+        if constexpr (BinaryScalar<T> || BinaryString<T>)
+            return true;
+        else if constexpr (BinaryVector<T>)
+            return DeferredEncodable<typename T::value_type>;
+        else if constexpr (std::is_aggregate_v<T> && std::is_class_v<T>)
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (DeferredEncodable<std::remove_cv_t<MemberTypeOf<I, T>>> && ...);
+            }(std::make_index_sequence<CountMembers<T>> {});
+        else
+            return false;
+    }();
+} // namespace detail
+
+/// Marks an object for deferred formatting, capturing a copy of it when pushed into a DeferredLog.
+///
+/// Trivially copyable objects without pointers or views are copied bytewise, others are encoded with
+/// SerializeBinary. Objects that can be captured neither way, such as ones with std::string_view members, are rejected
+/// at compile time: nothing but the object itself could tell whether the viewed memory outlives the formatting.
+template <typename Object>
+[[nodiscard]] auto Deferred(Object const& object) noexcept
+{
+    if constexpr (detail::DeferredSelfContained<Object>)
+        return DeferredObject<Object, DeferredCapture::Bytes> { std::addressof(object) };
+    else
+    {
+        static_assert(detail::DeferredEncodable<Object>,
+                      "Object refers to memory it does not own and cannot be captured, use Deferred(std::cref(...))");
+        return DeferredObject<Object, DeferredCapture::Encoded> { std::addressof(object) };
+    }
+}
+
+/// Marks an object for deferred formatting by reference, e.g. Deferred(std::cref(config)).
+///
+/// Nothing but the address is captured, so the object must neither change nor go away until the record has been
+/// formatted, e.g. until DeferredLog::Flush returned.
+template <typename Object>
+[[nodiscard]] auto Deferred(std::reference_wrapper<Object> object) noexcept
+{
+    return DeferredObject<std::remove_const_t<Object>, DeferredCapture::Reference> { std::addressof(object.get()) };
+}
+
+namespace detail
+{
+    using DeferredFormatter = void (*)(std::string& output, std::byte const* payload, size_t size);
+
+    template <typename Object>
+    void FormatCopiedBytes(std::string& output, std::byte const* payload, size_t /*size*/)
+    {
+        auto bytes = std::array<std::byte, sizeof(Object)> {};
+        std::memcpy(bytes.data(), payload, sizeof(Object));
+        InspectTo(output, std::bit_cast<Object>(bytes));
+    }
+
+    template <typename Object>
+    void FormatEncoded(std::string& output, std::byte const* payload, size_t size)
+    {
+        auto object = Object {};
+        if (DeserializeBinary(std::span { payload, size }, object))
+            InspectTo(output, object);
+        else
+        {
+            output += "<undecodable ";
+            output += TypeNameOf<Object>;
+            output += " record of ";
+            output += std::to_string(size);
+            output += " bytes>";
+        }
+    }
+
+    template <typename Object>
+    void FormatReferenced(std::string& output, std::byte const* payload, size_t /*size*/)
+    {
+        Object const* object = nullptr;
+        std::memcpy(&object, payload, sizeof(object));
+        InspectTo(output, *object);
+    }
+} // namespace detail
+
+/// Log formatting its records on a background thread, so that producers only pay for capturing the objects.
+///
+/// Records are kept in a bounded lock-free ring buffer of slots with PayloadSize bytes each, which any number of
+/// threads may push into. A single background thread formats each record with InspectTo and passes the line to the
+/// sink, in the order the records were pushed. Records are dropped rather than blocking the producer if the buffer
+/// is full or their capture does not fit into a slot.
+template <size_t PayloadSize = 240>
+class DeferredLog
+{
+  public:
+    using Sink = std::function<void(std::string_view line)>;
+
+    /// Creates a log of at least capacity slots (rounded up to a power of two) passing formatted lines to sink.
+    DeferredLog(size_t capacity, Sink sink):
+        _mask { std::bit_ceil(std::max<size_t>(capacity, 2)) - 1 },
+        _slots { std::make_unique<Slot[]>(_mask + 1) },
+        _sink { std::move(sink) }
+    {
+        for (size_t i = 0; i <= _mask; ++i)
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        _consumer = std::jthread { [this](std::stop_token stop) { Consume(stop); } };
+    }
+
+    DeferredLog(DeferredLog const&) = delete;
+    DeferredLog& operator=(DeferredLog const&) = delete;
+
+    /// Formats all remaining records before returning.
+    ~DeferredLog() = default;
+
+    /// Captures the object and queues it for formatting.
+    ///
+    /// @return false if the record was dropped, because the buffer is full or the capture exceeds PayloadSize
+    template <typename Object, DeferredCapture Capture>
+    bool Push(DeferredObject<Object, Capture> const& deferred)
+    {
+        if constexpr (Capture == DeferredCapture::Bytes)
+        {
+            static_assert(sizeof(Object) <= PayloadSize, "Object exceeds the slot size, use Deferred(std::cref(...))");
+            return Publish(&detail::FormatCopiedBytes<Object>, deferred.object, sizeof(Object));
+        }
+        else if constexpr (Capture == DeferredCapture::Encoded)
+        {
+            // Reused per thread, so that capturing does not allocate once it has grown to the largest record.
+            thread_local auto scratch = std::vector<std::byte> {};
+            scratch.clear();
+            SerializeBinary(*deferred.object, scratch);
+            if (scratch.size() > PayloadSize)
+            {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return Publish(&detail::FormatEncoded<Object>, scratch.data(), scratch.size());
+        }
+        else
+            return Publish(&detail::FormatReferenced<Object>, &deferred.object, sizeof(deferred.object));
+    }
+
+    /// Blocks until all records pushed before the call have been passed to the sink.
+    void Flush() const
+    {
+        auto const pushed = _head.load(std::memory_order_acquire);
+        while (_formatted.load(std::memory_order_acquire) < pushed)
+            std::this_thread::yield();
+    }
+
+    /// Number of records dropped so far.
+    [[nodiscard]] size_t Dropped() const noexcept
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // Slot i is free for the push at position p if its sequence is p, and holds the record of position p once its
+    // sequence is p + 1. The consumer then releases it for position p + capacity.
+    struct alignas(64) Slot
+    {
+        std::atomic<size_t> sequence;
+        detail::DeferredFormatter format;
+        size_t size;
+        std::byte payload[PayloadSize];
+    };
+
+    static constexpr auto IdleInterval = std::chrono::microseconds(100);
+
+    bool Publish(detail::DeferredFormatter format, void const* payload, size_t size)
+    {
+        auto pos = _head.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &_slots[pos & _mask];
+            auto const sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (sequence < pos)
+            {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+                pos = _head.load(std::memory_order_relaxed);
+        }
+        slot->format = format;
+        slot->size = size;
+        std::memcpy(slot->payload, payload, size);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Formats the next record, if there is one that has been published.
+    bool FormatNext(std::string& line)
+    {
+        auto& slot = _slots[_tail & _mask];
+        if (slot.sequence.load(std::memory_order_acquire) != _tail + 1)
+            return false;
+        line.clear();
+        slot.format(line, slot.payload, slot.size);
+        _sink(line);
+        slot.sequence.store(_tail + _mask + 1, std::memory_order_release);
+        _formatted.store(++_tail, std::memory_order_release);
+        return true;
+    }
+
+    void Consume(std::stop_token stop)
+    {
+        auto line = std::string {};
+        while (true)
+        {
+            if (FormatNext(line))
+                continue;
+            if (stop.stop_requested())
+            {
+                while (_formatted.load(std::memory_order_relaxed) < _head.load(std::memory_order_acquire))
+                    if (!FormatNext(line))
+                        std::this_thread::yield();
+                return;
+            }
+            std::this_thread::sleep_for(IdleInterval);
+        }
+    }
+
+    size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    Sink _sink;
+    alignas(64) std::atomic<size_t> _head { 0 };
+    alignas(64) std::atomic<size_t> _formatted { 0 };
+    std::atomic<size_t> _dropped { 0 };
+    size_t _tail = 0; // consumer only
+    std::jthread _consumer;
+};
+
+} // namespace Reflection
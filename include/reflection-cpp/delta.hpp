@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Reflection
+{
+
+// ---------------------------------------------------------------------------
+// Delta layout: a bitmap of the changed members, one bit per member in declaration order,
+// followed by the values of only the changed members in the fixed binary layout.
+// Nested aggregates are encoded as a delta themselves, so a single changed member deep inside
+// costs one bitmap per nesting level plus that member.
+
+namespace detail
+{
+    // Members that are diffed member-wise rather than compared and sent as a whole.
+    template <typename T>
+    concept DeltaRecord = std::is_aggregate_v<T> && !BinaryScalar<T> && !BinaryStringLike<T> && !BinaryVector<T>;
+
+    template <typename T>
+    constexpr size_t DeltaBitmapSize = (CountMembers<T> + 7) / 8;
+
+    // Appends the delta between lhs and rhs and returns whether any member changed.
+    template <DeltaRecord T>
+    bool WriteDelta(std::vector<std::byte>& output, T const& lhs, T const& rhs)
+    {
+        auto bitmap = std::array<std::uint8_t, DeltaBitmapSize<T>> {};
+        auto const bitmapOffset = output.size();
+        output.resize(output.size() + bitmap.size());
+
+        template_for<0, CountMembers<T>>([&]<auto I>() {
+            using Member = MemberTypeOf<I, T>;
+            auto const& before = GetMemberAt<I>(lhs);
+            auto const& after = GetMemberAt<I>(rhs);
+            bool changed = false;
+            if constexpr (DeltaRecord<Member>)
+            {
+                auto const memberOffset = output.size();
+                changed = WriteDelta(output, before, after);
+                if (!changed)
+                    output.resize(memberOffset);
+            }
+            else if (before != after)
+            {
+                WriteBinaryValue(output, after);
+                changed = true;
+            }
+            if (changed)
+                bitmap[I / 8] |= static_cast<std::uint8_t>(1u << (I % 8));
+        });
+
+        std::memcpy(output.data() + bitmapOffset, bitmap.data(), bitmap.size());
+        return std::ranges::any_of(bitmap, [](auto bits) { return bits != 0; });
+    }
+
+    template <DeltaRecord T>
+    [[nodiscard]] bool ReadDelta(BinaryReader& reader, T& object)
+    {
+        std::span<std::byte const> bitmap;
+        if (!reader.Take(DeltaBitmapSize<T>, bitmap))
+            return false;
+
+        bool ok = true;
+        template_for<0, CountMembers<T>>([&]<auto I>() {
+            if (!ok || (std::to_integer<unsigned>(bitmap[I / 8]) & (1u << (I % 8))) == 0)
+                return;
+            auto& member = GetMemberAt<I>(object);
+            if constexpr (DeltaRecord<MemberTypeOf<I, T>>)
+                ok = ReadDelta(reader, member);
+            else
+                ok = ReadBinaryValue(reader, member);
+        });
+        return ok;
+    }
+} // namespace detail
+
+/// Appends to output the delta that turns before into after, and returns whether any member changed.
+///
+/// Only the changed members are written, prefixed with a bitmap of the changed members.
+/// Strings and vectors are sent as a whole when they changed, nested aggregates are diffed recursively.
+/// If nothing changed, the delta consists of an all-zero bitmap only.
+template <typename Object>
+    requires detail::DeltaRecord<Object>
+bool EncodeDelta(Object const& before, Object const& after, std::vector<std::byte>& output)
+{
+    return detail::WriteDelta(output, before, after);
+}
+
+/// Applies a delta previously written with EncodeDelta to object in place, consuming its bytes from the reader.
+///
+/// @return false if the input is truncated, in which case object may have been partially updated
+template <typename Object>
+    requires detail::DeltaRecord<Object>
+[[nodiscard]] bool ApplyDelta(Object& object, BinaryReader& reader)
+{
+    return detail::ReadDelta(reader, object);
+}
+
+template <typename Object>
+    requires detail::DeltaRecord<Object>
+[[nodiscard]] bool ApplyDelta(Object& object, std::span<std::byte const> input)
+{
+    auto reader = BinaryReader { input };
+    return ApplyDelta(object, reader);
+}
+
+} // namespace Reflection
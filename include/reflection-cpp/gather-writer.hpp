@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <sys/uio.h>
+#endif
+
+namespace Reflection
+{
+
+namespace detail
+{
+#if defined(_WIN32)
+    struct GatherSegment
+    {
+        void* iov_base;
+        size_t iov_len;
+    };
+#else
+    using GatherSegment = ::iovec;
+#endif
+
+    // Elements whose representation in memory is their binary representation, such that a vector of them can be
+    // written as is.
+    template <typename T>
+    concept GatherInPlace =
+        BinaryScalar<T> && !std::is_same_v<T, bool> && (std::endian::native == std::endian::little || sizeof(T) == 1);
+
+    // Number of segments written by one call of writev, and after which the segments queued are flushed.
+#if defined(IOV_MAX)
+    constexpr size_t MaxGatherSegments = IOV_MAX;
+#elif defined(_WIN32)
+    constexpr size_t MaxGatherSegments = 1024;
+#else
+    constexpr size_t MaxGatherSegments = 16; // the minimum POSIX allows
+#endif
+
+    // Writes all segments, resuming after partial writes. Segments are consumed in the process.
+    [[nodiscard]] inline bool WriteSegments(int fd, std::span<GatherSegment> segments) noexcept
+    {
+#if defined(_WIN32)
+        for (auto& segment: segments)
+        {
+            auto const* data = static_cast<char const*>(segment.iov_base);
+            while (segment.iov_len > 0)
+            {
+                auto const chunk = static_cast<unsigned>(std::min<size_t>(segment.iov_len, INT_MAX));
+                auto const written = ::_write(fd, data, chunk);
+                if (written < 0)
+                    return false;
+                data += written;
+                segment.iov_len -= static_cast<size_t>(written);
+            }
+        }
+        return true;
+#else
+        size_t index = 0;
+        while (index < segments.size())
+        {
+            auto const count = std::min(segments.size() - index, MaxGatherSegments);
+            auto const written = ::writev(fd, segments.data() + index, static_cast<int>(count));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            for (auto remaining = static_cast<size_t>(written); remaining > 0;)
+            {
+                auto& segment = segments[index];
+                if (remaining < segment.iov_len)
+                {
+                    segment.iov_base = static_cast<std::byte*>(segment.iov_base) + remaining;
+                    segment.iov_len -= remaining;
+                    break;
+                }
+                remaining -= segment.iov_len;
+                ++index;
+            }
+        }
+        return true;
+#endif
+    }
+} // namespace detail
+
+/// Writes objects in the layout of SerializeBinary to a file descriptor with scatter-gather I/O (writev).
+///
+/// Length prefixes, scalars and short strings are copied into a staging buffer, while the contents of strings and
+/// vectors of at least inPlaceThreshold bytes are referenced where they are, such that large members are passed to
+/// the kernel without being copied in user space first:
+///
+///     auto writer = GatherWriter { fd };
+///     for (auto const& document: documents)
+///         writer.Write(document);
+///     writer.Flush();
+///
+/// Referenced members must stay unchanged until they have been written, which is ensured once Flush returned.
+/// The writer flushes on its own whenever the staging buffer is full, IOV_MAX segments are queued or MaxPendingBytes
+/// are pending, and when it is destroyed, in which case errors go unnoticed.
+/// On Windows the segments are written one by one, as there is no writev.
+class GatherWriter
+{
+  public:
+    static constexpr size_t DefaultStagingSize = 64 * 1024;
+    static constexpr size_t DefaultInPlaceThreshold = 256;
+    static constexpr size_t MaxPendingBytes = 1024 * 1024;
+
+    explicit GatherWriter(int fd,
+                          size_t stagingSize = DefaultStagingSize,
+                          size_t inPlaceThreshold = DefaultInPlaceThreshold):
+        _fd { fd },
+        _staging { std::make_unique_for_overwrite<std::byte[]>(std::max<size_t>(stagingSize, sizeof(std::uint64_t))) },
+        _stagingCapacity { std::max<size_t>(stagingSize, sizeof(std::uint64_t)) },
+        _inPlaceThreshold { inPlaceThreshold }
+    {
+    }
+
+    GatherWriter(GatherWriter const&) = delete;
+    GatherWriter& operator=(GatherWriter const&) = delete;
+
+    ~GatherWriter()
+    {
+        Flush();
+    }
+
+    /// Queues an object for writing.
+    ///
+    /// The object must be an lvalue that stays alive and unchanged until it has been flushed, as its larger members
+    /// are referenced rather than copied. Temporaries are rejected at compile time.
+    ///
+    /// @return false if an earlier write failed, with errno describing the error of that write
+    template <typename Object>
+    bool Write(Object const& object)
+    {
+        Queue(object);
+        return _good;
+    }
+
+    template <typename Object>
+    bool Write(Object const&&) = delete;
+
+    /// Writes all queued bytes.
+    ///
+    /// @return false if this or an earlier write failed, with errno describing the error of that write
+    bool Flush()
+    {
+        if (_good && !_segments.empty())
+            _good = detail::WriteSegments(_fd, _segments);
+        _segments.clear();
+        _stagingSize = 0;
+        _pending = 0;
+        return _good;
+    }
+
+    /// Number of bytes queued but not yet written.
+    [[nodiscard]] size_t pending() const noexcept
+    {
+        return _pending;
+    }
+
+    /// Number of bytes written in place, without being copied into the staging buffer, since construction.
+    [[nodiscard]] size_t inPlaceBytes() const noexcept
+    {
+        return _inPlaceBytes;
+    }
+
+  private:
+    template <typename T>
+    void Queue(T const& value)
+    {
+        if constexpr (detail::BinaryScalar<T>)
+        {
+            auto const bits = detail::ToWireBits(value);
+            Stage(&bits, sizeof(bits));
+        }
+        else if constexpr (detail::BinaryStringLike<T>)
+        {
+            auto const text = std::string_view(value);
+            Queue(static_cast<BinaryLength>(text.size()));
+            QueueBytes(text.data(), text.size());
+        }
+        else if constexpr (detail::BinaryVector<T>)
+        {
+            using Element = typename T::value_type;
+            Queue(static_cast<BinaryLength>(value.size()));
+            if constexpr (detail::GatherInPlace<Element>)
+                QueueBytes(value.data(), value.size() * sizeof(Element));
+            else
+                for (auto const& element: value)
+                    Queue(element);
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be encoded in the binary format");
+            CallOnMembersWithoutName(value, [&]<size_t I, typename M>(M const& member) { Queue(member); });
+        }
+    }
+
+    void QueueBytes(void const* data, size_t size)
+    {
+        if (size < _inPlaceThreshold)
+            return Stage(data, size);
+        _segments.push_back({ .iov_base = const_cast<void*>(data), .iov_len = size });
+        _inPlaceBytes += size;
+        _pending += size;
+        FlushIfFull();
+    }
+
+    // Bounds the segments and the referenced memory queued, as the staging buffer bounds the copied bytes.
+    void FlushIfFull()
+    {
+        if (_segments.size() >= detail::MaxGatherSegments || _pending >= MaxPendingBytes)
+            Flush();
+    }
+
+    void Stage(void const* data, size_t size)
+    {
+        auto const* bytes = static_cast<std::byte const*>(data);
+        while (size > 0)
+        {
+            if (_stagingSize == _stagingCapacity)
+                Flush();
+            auto const count = std::min(size, _stagingCapacity - _stagingSize);
+            auto* const target = _staging.get() + _stagingSize;
+            std::memcpy(target, bytes, count);
+            auto const extendsLast = !_segments.empty()
+                                     && static_cast<std::byte*>(_segments.back().iov_base) + _segments.back().iov_len
+                                            == target;
+            _stagingSize += count;
+            _pending += count;
+            bytes += count;
+            size -= count;
+            if (extendsLast)
+                _segments.back().iov_len += count;
+            else
+            {
+                _segments.push_back({ .iov_base = target, .iov_len = count });
+                FlushIfFull();
+            }
+        }
+    }
+
+    int _fd;
+    std::unique_ptr<std::byte[]> _staging;
+    size_t _stagingCapacity;
+    size_t _stagingSize = 0;
+    size_t _inPlaceThreshold;
+    size_t _inPlaceBytes = 0;
+    size_t _pending = 0;
+    std::vector<detail::GatherSegment> _segments;
+    bool _good = true;
+};
+
+} // namespace Reflection
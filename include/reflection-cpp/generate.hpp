@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+/// Distribution of the values Generate produces for every value of type T, e.g. every std::string member.
+///
+/// Specialize it to change the defaults for a type, by providing any of:
+/// - min and max, the inclusive range of arithmetic values (0 to 1'000'000, or 0 to 1000 for floating point),
+/// - values, an array to pick values from uniformly, which enums must provide,
+/// - minSize and maxSize, the inclusive range of string lengths (4 to 16) or vector sizes (0 to 4).
+///
+/// namespace Reflection
+/// {
+///     template <>
+///     struct GenerateDistribution<Side>
+///     {
+///         static constexpr std::array values = { Side::Buy, Side::Sell };
+///     };
+/// }
+template <typename T>
+struct GenerateDistribution
+{
+};
+
+namespace detail
+{
+    template <typename T>
+    concept GenerateString =
+        std::same_as<T, std::basic_string<char, typename T::traits_type, typename T::allocator_type>>;
+
+    template <typename T>
+    concept GenerateVector = std::same_as<T, std::vector<typename T::value_type, typename T::allocator_type>>;
+
+    // Inclusive range of arithmetic values.
+    template <typename T>
+    constexpr auto GenerateValueRange = [] {
+        using Distribution = GenerateDistribution<T>;
+        auto range = std::pair<T, T> { T { 0 }, T { 0 } };
+        if constexpr (std::is_floating_point_v<T>)
+            range.second = T { 1000 };
+        else
+            range.second = static_cast<T>(std::min<std::uint64_t>(std::numeric_limits<T>::max(), 1'000'000));
+        if constexpr (requires { Distribution::min; })
+            range.first = static_cast<T>(Distribution::min);
+        if constexpr (requires { Distribution::max; })
+            range.second = static_cast<T>(Distribution::max);
+        return range;
+    }();
+
+    // Inclusive range of string lengths and vector sizes.
+    template <typename T>
+    constexpr auto GenerateSizeRange = [] {
+        using Distribution = GenerateDistribution<T>;
+        auto range = GenerateString<T> ? std::pair<size_t, size_t> { 4, 16 } : std::pair<size_t, size_t> { 0, 4 };
+        if constexpr (requires { Distribution::minSize; })
+            range.first = Distribution::minSize;
+        if constexpr (requires { Distribution::maxSize; })
+            range.second = Distribution::maxSize;
+        return range;
+    }();
+
+    template <std::uniform_random_bit_generator Rng>
+    [[nodiscard]] std::uint64_t RandomBits(Rng& rng)
+    {
+        if constexpr (Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint64_t>::max())
+            return rng();
+        else
+            return std::uniform_int_distribution<std::uint64_t> {}(rng);
+    }
+
+    // Uniform integer in [min, max]. The modulo bias is at most (max - min + 1) / 2^64, which is irrelevant for
+    // generated data and much cheaper than std::uniform_int_distribution.
+    template <std::integral T, typename Rng>
+    [[nodiscard]] T RandomIntegerIn(Rng& rng, T min, T max)
+    {
+        auto const low = static_cast<std::uint64_t>(min);
+        auto const span = static_cast<std::uint64_t>(max) - low;
+        auto const bits = RandomBits(rng);
+        if (span == std::numeric_limits<std::uint64_t>::max())
+            return static_cast<T>(bits);
+        return static_cast<T>(low + bits % (span + 1));
+    }
+
+    template <typename T, typename Rng>
+    void GenerateValue(Rng& rng, T& value)
+    {
+        using Distribution = GenerateDistribution<T>;
+        if constexpr (requires { Distribution::values; })
+            value = Distribution::values[RandomIntegerIn<size_t>(rng, 0, std::size(Distribution::values) - 1)];
+        else if constexpr (std::is_same_v<T, bool>)
+            value = (RandomBits(rng) & 1) != 0;
+        else if constexpr (std::is_integral_v<T>)
+            value = RandomIntegerIn(rng, GenerateValueRange<T>.first, GenerateValueRange<T>.second);
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            constexpr auto range = GenerateValueRange<T>;
+            auto const unit = static_cast<double>(RandomBits(rng) >> 11) * 0x1.0p-53;
+            value = static_cast<T>(range.first + (range.second - range.first) * unit);
+        }
+        else if constexpr (GenerateString<T>)
+        {
+            constexpr auto range = GenerateSizeRange<T>;
+            auto const length = RandomIntegerIn(rng, range.first, range.second);
+            value.resize(length);
+            // Every draw of 64 random bits yields 8 lowercase letters.
+            for (size_t i = 0; i < length; i += 8)
+            {
+                auto bits = RandomBits(rng);
+                for (size_t j = i; j < std::min(length, i + 8); ++j, bits >>= 8)
+                    value[j] = static_cast<char>('a' + (((bits & 0xFF) * 26) >> 8));
+            }
+        }
+        else if constexpr (GenerateVector<T>)
+        {
+            constexpr auto range = GenerateSizeRange<T>;
+            value.resize(RandomIntegerIn(rng, range.first, range.second));
+            for (auto& element: value)
+                GenerateValue(rng, element);
+        }
+        else
+        {
+            static_assert(!std::is_enum_v<T>, "Enums must specialize GenerateDistribution with their values");
+            static_assert(std::is_aggregate_v<T>, "Type cannot be generated");
+            if constexpr (std::is_aggregate_v<T>)
+                EnumerateMembers(value, [&]<size_t I>(auto& member) { GenerateValue(rng, member); });
+        }
+    }
+} // namespace detail
+
+/// Overwrites value with random data drawn from rng.
+///
+/// Arithmetic values, enums, strings and vectors are drawn according to the GenerateDistribution of their type.
+/// Aggregates are generated member by member, recursing into nested aggregates and the elements of vectors.
+/// The same seed yields the same data with the same standard library.
+template <std::uniform_random_bit_generator Rng, typename T>
+void GenerateInto(Rng& rng, T& value)
+{
+    detail::GenerateValue(rng, value);
+}
+
+/// Generates every object of a preallocated range in place, e.g. a std::vector<T> resized beforehand.
+template <std::uniform_random_bit_generator Rng, typename T>
+void Generate(Rng& rng, std::span<T> objects)
+{
+    for (auto& object: objects)
+        detail::GenerateValue(rng, object);
+}
+
+/// Generates count random objects, e.g. Generate<Order>(rng, 1'000'000) as the data set of a benchmark.
+template <typename T, std::uniform_random_bit_generator Rng>
+[[nodiscard]] std::vector<T> Generate(Rng& rng, size_t count)
+{
+    auto objects = std::vector<T>(count);
+    Generate(rng, std::span { objects });
+    return objects;
+}
+
+} // namespace Reflection
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+namespace detail
+{
+    template <typename T>
+    concept HashableKey = std::equality_comparable<T> && requires(T const& value) {
+        { std::hash<T> {}(value) } -> std::convertible_to<size_t>;
+    };
+
+    // The type of the member a member pointer refers to, e.g. std::string for &Person::name.
+    template <auto Member>
+    using IndexKeyOf = std::remove_cvref_t<decltype(std::declval<MemberClassType<Member> const&>().*Member)>;
+} // namespace detail
+
+/// Vector of objects with a hash index on each of the given members, e.g.
+/// IndexedVector<Employee, &Employee::id, &Employee::department>.
+///
+/// Lookups by any indexed member take constant time on average. Indexes are not unique, several objects may share
+/// the same key. Objects are only mutable through Update and Set, which compare the indexed members before and after
+/// the change and only re-index those that actually changed.
+///
+/// Erase moves the last object into the erased position (swap and pop), so positions are not stable across erasure.
+/// Erasing or re-indexing an object walks the objects sharing its key, which is cheap unless a key is very common.
+template <typename T, auto... Keys>
+    requires(sizeof...(Keys) > 0 && (std::same_as<MemberClassType<Keys>, T> && ...)
+             && (detail::HashableKey<detail::IndexKeyOf<Keys>> && ...))
+class IndexedVector
+{
+  public:
+    using value_type = T;
+    using size_type = size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /// Position returned by Find if no object has the requested key.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /// Whether Member is one of the indexed members.
+    template <auto Member>
+    static constexpr bool IsIndexed =
+        std::same_as<MemberClassType<Member>, T> && ((MemberIndexOf<Member> == MemberIndexOf<Keys>) || ...);
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _objects.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return _objects.empty();
+    }
+
+    [[nodiscard]] T const& operator[](size_t pos) const noexcept
+    {
+        return _objects[pos];
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return _objects.begin();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return _objects.end();
+    }
+
+    void Reserve(size_t capacity)
+    {
+        _objects.reserve(capacity);
+        ForEachIndex([&]<auto I>() { std::get<I>(_indexes).reserve(capacity); });
+    }
+
+    void Clear() noexcept
+    {
+        _objects.clear();
+        ForEachIndex([&]<auto I>() { std::get<I>(_indexes).clear(); });
+    }
+
+    /// Appends object, indexes it and returns its position.
+    size_t Insert(T object)
+    {
+        auto const pos = _objects.size();
+        _objects.push_back(std::move(object));
+        ForEachIndex([&]<auto I>() { std::get<I>(_indexes).emplace(_objects[pos].*KeyAt<I>, pos); });
+        return pos;
+    }
+
+    /// Erases the object at pos by moving the last object into its place.
+    void Erase(size_t pos)
+    {
+        auto const last = _objects.size() - 1;
+        ForEachIndex([&]<auto I>() {
+            auto& index = std::get<I>(_indexes);
+            index.erase(EntryOf(index, _objects[pos].*KeyAt<I>, pos));
+            if (pos != last)
+                EntryOf(index, _objects[last].*KeyAt<I>, last)->second = pos;
+        });
+        if (pos != last)
+            _objects[pos] = std::move(_objects[last]);
+        _objects.pop_back();
+    }
+
+    /// Calls fn with a mutable reference to the object at pos, then re-indexes the indexed members it changed.
+    template <typename Fn>
+        requires std::invocable<Fn&, T&>
+    void Update(size_t pos, Fn&& fn)
+    {
+        auto& object = _objects[pos];
+        auto const before = std::tuple<detail::IndexKeyOf<Keys>...> { object.*Keys... };
+        std::invoke(fn, object);
+        ForEachIndex([&]<auto I>() {
+            if (std::get<I>(before) != object.*KeyAt<I>)
+                Reindex<I>(std::get<I>(before), pos);
+        });
+    }
+
+    /// Assigns value to Member of the object at pos, re-indexing only if Member is indexed and its value changed.
+    template <auto Member, typename Value>
+        requires std::same_as<MemberClassType<Member>, T>
+                 && std::is_assignable_v<detail::IndexKeyOf<Member>&, Value&&>
+    void Set(size_t pos, Value&& value)
+    {
+        auto& member = GetMemberAt<MemberIndexOf<Member>>(_objects[pos]);
+        if constexpr (IsIndexed<Member>)
+        {
+            constexpr auto I = SlotOf<Member>;
+            if (member == value)
+                return;
+            auto before = std::move(member);
+            member = std::forward<Value>(value);
+            Reindex<I>(before, pos);
+        }
+        else
+            member = std::forward<Value>(value);
+    }
+
+    /// Position of an object whose Key member equals key, or npos if there is none.
+    template <auto Key>
+        requires IsIndexed<Key>
+    [[nodiscard]] size_t Find(detail::IndexKeyOf<Key> const& key) const
+    {
+        auto const& index = std::get<SlotOf<Key>>(_indexes);
+        auto const i = index.find(key);
+        return i != index.end() ? i->second : npos;
+    }
+
+    /// Positions of all objects whose Key member equals key, in no particular order.
+    template <auto Key>
+        requires IsIndexed<Key>
+    [[nodiscard]] auto FindAll(detail::IndexKeyOf<Key> const& key) const
+    {
+        auto const [first, last] = std::get<SlotOf<Key>>(_indexes).equal_range(key);
+        return std::ranges::subrange(first, last) | std::views::values;
+    }
+
+    /// Number of objects whose Key member equals key.
+    template <auto Key>
+        requires IsIndexed<Key>
+    [[nodiscard]] size_t Count(detail::IndexKeyOf<Key> const& key) const
+    {
+        return std::get<SlotOf<Key>>(_indexes).count(key);
+    }
+
+  private:
+    template <size_t I>
+    static constexpr auto KeyAt = std::get<I>(std::tuple { Keys... });
+
+    // Position of Member within Keys, matched by member index.
+    template <auto Member>
+    static constexpr size_t SlotOf = [] {
+        constexpr size_t indices[] = { MemberIndexOf<Keys>... };
+        for (size_t i = 0; i < sizeof...(Keys); ++i)
+            if (indices[i] == MemberIndexOf<Member>)
+                return i;
+        return sizeof...(Keys);
+    }();
+
+    template <typename F>
+    static constexpr void ForEachIndex(F&& f)
+    {
+        template_for<0, sizeof...(Keys)>(std::forward<F>(f));
+    }
+
+    // The entry of the object at pos among the entries for key, which must exist.
+    template <typename Index>
+    static auto EntryOf(Index& index, typename Index::key_type const& key, size_t pos)
+    {
+        auto [i, last] = index.equal_range(key);
+        while (i != last && i->second != pos)
+            ++i;
+        return i;
+    }
+
+    template <size_t I>
+    void Reindex(detail::IndexKeyOf<KeyAt<I>> const& before, size_t pos)
+    {
+        auto& index = std::get<I>(_indexes);
+        index.erase(EntryOf(index, before, pos));
+        index.emplace(_objects[pos].*KeyAt<I>, pos);
+    }
+
+    std::vector<T> _objects;
+    std::tuple<std::unordered_multimap<detail::IndexKeyOf<Keys>, size_t>...> _indexes;
+};
+
+} // namespace Reflection
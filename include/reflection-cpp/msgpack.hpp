@@ -0,0 +1,636 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/reflection.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Reflection
+{
+
+/// How ToMsgPack encodes aggregates.
+enum class MsgPackLayout : std::uint8_t
+{
+    /// A map from member names to values, which readers can match by name.
+    Map,
+    /// An array of the values in declaration order, which is smaller but requires both sides to agree on the order.
+    Array,
+};
+
+namespace detail
+{
+    // Type bytes of the MessagePack format, the fix* ones holding their length in the low bits.
+    constexpr std::uint8_t MsgPackFixMap = 0x80;
+    constexpr std::uint8_t MsgPackFixArray = 0x90;
+    constexpr std::uint8_t MsgPackFixStr = 0xA0;
+    constexpr std::uint8_t MsgPackNil = 0xC0;
+    constexpr std::uint8_t MsgPackFalse = 0xC2;
+    constexpr std::uint8_t MsgPackTrue = 0xC3;
+    constexpr std::uint8_t MsgPackFloat32 = 0xCA;
+    constexpr std::uint8_t MsgPackFloat64 = 0xCB;
+    constexpr std::uint8_t MsgPackUInt8 = 0xCC;
+    constexpr std::uint8_t MsgPackInt8 = 0xD0;
+    constexpr std::uint8_t MsgPackStr8 = 0xD9;
+    constexpr std::uint8_t MsgPackArray16 = 0xDC;
+    constexpr std::uint8_t MsgPackMap16 = 0xDE;
+    constexpr std::uint8_t MsgPackNegativeFixInt = 0xE0;
+
+    template <typename U>
+    [[nodiscard]] constexpr U ToBigEndian(U value) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::big || sizeof(U) == 1)
+            return value;
+        else
+        {
+            U result = 0;
+            for (size_t i = 0; i < sizeof(U); ++i)
+            {
+                result = static_cast<U>((result << 8) | (value & 0xFF));
+                value = static_cast<U>(value >> 8);
+            }
+            return result;
+        }
+    }
+
+    // Appends a type byte followed by a big endian value.
+    template <typename U>
+    void AppendMsgPackTyped(std::vector<std::byte>& output, std::uint8_t type, U value)
+    {
+        auto bytes = std::array<std::byte, 1 + sizeof(U)> {};
+        bytes[0] = std::byte { type };
+        auto const big = ToBigEndian(value);
+        std::memcpy(bytes.data() + 1, &big, sizeof(U));
+        AppendBytes(output, bytes.data(), bytes.size());
+    }
+
+    inline void AppendMsgPackUnsigned(std::vector<std::byte>& output, std::uint64_t value)
+    {
+        if (value < 0x80)
+            output.push_back(static_cast<std::byte>(value));
+        else if (value <= std::numeric_limits<std::uint8_t>::max())
+            AppendMsgPackTyped(output, MsgPackUInt8, static_cast<std::uint8_t>(value));
+        else if (value <= std::numeric_limits<std::uint16_t>::max())
+            AppendMsgPackTyped(output, MsgPackUInt8 + 1, static_cast<std::uint16_t>(value));
+        else if (value <= std::numeric_limits<std::uint32_t>::max())
+            AppendMsgPackTyped(output, MsgPackUInt8 + 2, static_cast<std::uint32_t>(value));
+        else
+            AppendMsgPackTyped(output, MsgPackUInt8 + 3, value);
+    }
+
+    inline void AppendMsgPackSigned(std::vector<std::byte>& output, std::int64_t value)
+    {
+        if (value >= 0)
+            AppendMsgPackUnsigned(output, static_cast<std::uint64_t>(value));
+        else if (value >= -32)
+            output.push_back(static_cast<std::byte>(value));
+        else if (value >= std::numeric_limits<std::int8_t>::min())
+            AppendMsgPackTyped(output, MsgPackInt8, static_cast<std::uint8_t>(value));
+        else if (value >= std::numeric_limits<std::int16_t>::min())
+            AppendMsgPackTyped(output, MsgPackInt8 + 1, static_cast<std::uint16_t>(value));
+        else if (value >= std::numeric_limits<std::int32_t>::min())
+            AppendMsgPackTyped(output, MsgPackInt8 + 2, static_cast<std::uint32_t>(value));
+        else
+            AppendMsgPackTyped(output, MsgPackInt8 + 3, static_cast<std::uint64_t>(value));
+    }
+
+    // Appends the header of a string, array or map: the fix* type holding the size if it is below fixLimit,
+    // otherwise the type byte for 8 (strings only), 16 or 32 bit sizes followed by the size.
+    inline void AppendMsgPackHeader(
+        std::vector<std::byte>& output, std::uint8_t fixType, size_t fixLimit, std::uint8_t type16, size_t size)
+    {
+        if (size < fixLimit)
+            output.push_back(static_cast<std::byte>(fixType | size));
+        else if (fixType == MsgPackFixStr && size <= std::numeric_limits<std::uint8_t>::max())
+            AppendMsgPackTyped(output, MsgPackStr8, static_cast<std::uint8_t>(size));
+        else if (size <= std::numeric_limits<std::uint16_t>::max())
+            AppendMsgPackTyped(output, type16, static_cast<std::uint16_t>(size));
+        else
+            AppendMsgPackTyped(output, type16 + 1, static_cast<std::uint32_t>(size));
+    }
+
+    [[nodiscard]] constexpr size_t MsgPackStringHeaderSize(size_t length) noexcept
+    {
+        return length < 32 ? 1 : length <= std::numeric_limits<std::uint8_t>::max() ? 2 : 3;
+    }
+
+    // Names of the members of Object, each encoded as a MessagePack string, and the header of the map holding them.
+    template <typename Object>
+    struct MsgPackKeys
+    {
+        static constexpr size_t MemberCount = CountMembers<Object>;
+        static_assert(MemberCount <= std::numeric_limits<std::uint16_t>::max(), "Too many members for a map16");
+
+        static constexpr auto offsets = [] {
+            auto result = std::array<size_t, MemberCount + 1> {};
+            for (size_t i = 0; i < MemberCount; ++i)
+            {
+                auto const length = MemberNames<Object>[i].size();
+                result[i + 1] = result[i] + MsgPackStringHeaderSize(length) + length;
+            }
+            return result;
+        }();
+
+        static constexpr auto bytes = [] {
+            auto result = std::array<std::byte, offsets[MemberCount]> {};
+            for (size_t i = 0; i < MemberCount; ++i)
+            {
+                auto const name = MemberNames<Object>[i];
+                auto pos = offsets[i];
+                if (name.size() < 32)
+                    result[pos++] = static_cast<std::byte>(MsgPackFixStr | name.size());
+                else if (name.size() <= std::numeric_limits<std::uint8_t>::max())
+                {
+                    result[pos++] = std::byte { MsgPackStr8 };
+                    result[pos++] = static_cast<std::byte>(name.size());
+                }
+                else
+                {
+                    result[pos++] = std::byte { MsgPackStr8 + 1 };
+                    result[pos++] = static_cast<std::byte>(name.size() >> 8);
+                    result[pos++] = static_cast<std::byte>(name.size() & 0xFF);
+                }
+                for (char const c: name)
+                    result[pos++] = static_cast<std::byte>(c);
+            }
+            return result;
+        }();
+
+        static constexpr auto mapHeader = [] {
+            auto result = std::array<std::byte, MemberCount < 16 ? 1 : 3> {};
+            if constexpr (MemberCount < 16)
+                result[0] = static_cast<std::byte>(MsgPackFixMap | MemberCount);
+            else
+            {
+                result[0] = std::byte { MsgPackMap16 };
+                result[1] = static_cast<std::byte>(MemberCount >> 8);
+                result[2] = static_cast<std::byte>(MemberCount & 0xFF);
+            }
+            return result;
+        }();
+    };
+
+    template <MsgPackLayout Layout, typename T>
+    void WriteMsgPackValue(std::vector<std::byte>& output, T const& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            output.push_back(std::byte { value ? MsgPackTrue : MsgPackFalse });
+        else if constexpr (std::is_enum_v<T>)
+            WriteMsgPackValue<Layout>(output, static_cast<std::underlying_type_t<T>>(value));
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            AppendMsgPackSigned(output, value);
+        else if constexpr (std::is_integral_v<T>)
+            AppendMsgPackUnsigned(output, value);
+        else if constexpr (std::is_same_v<T, float>)
+            AppendMsgPackTyped(output, MsgPackFloat32, std::bit_cast<std::uint32_t>(value));
+        else if constexpr (std::is_same_v<T, double>)
+            AppendMsgPackTyped(output, MsgPackFloat64, std::bit_cast<std::uint64_t>(value));
+        else if constexpr (BinaryStringLike<T>)
+        {
+            auto const text = std::string_view(value);
+            AppendMsgPackHeader(output, MsgPackFixStr, 32, MsgPackStr8 + 1, text.size());
+            AppendBytes(output, text.data(), text.size());
+        }
+        else if constexpr (IsOptional<T>)
+        {
+            if (value)
+                WriteMsgPackValue<Layout>(output, *value);
+            else
+                output.push_back(std::byte { MsgPackNil });
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            AppendMsgPackHeader(output, MsgPackFixArray, 16, MsgPackArray16, value.size());
+            for (auto const& element: value)
+                WriteMsgPackValue<Layout>(output, element);
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be encoded as MessagePack");
+            using Keys = MsgPackKeys<T>;
+            if constexpr (Layout == MsgPackLayout::Map)
+            {
+                AppendBytes(output, Keys::mapHeader.data(), Keys::mapHeader.size());
+                EnumerateMembers(value, [&]<size_t I>(auto const& member) {
+                    AppendBytes(output, Keys::bytes.data() + Keys::offsets[I], Keys::offsets[I + 1] - Keys::offsets[I]);
+                    WriteMsgPackValue<Layout>(output, member);
+                });
+            }
+            else
+            {
+                AppendMsgPackHeader(output, MsgPackFixArray, 16, MsgPackArray16, Keys::MemberCount);
+                EnumerateMembers(value,
+                                 [&]<size_t I>(auto const& member) { WriteMsgPackValue<Layout>(output, member); });
+            }
+        }
+    }
+
+    template <typename U>
+    [[nodiscard]] bool ReadBigEndian(BinaryReader& reader, U& value) noexcept
+    {
+        std::span<std::byte const> bytes;
+        if (!reader.Take(sizeof(U), bytes))
+            return false;
+        std::memcpy(&value, bytes.data(), sizeof(U));
+        value = ToBigEndian(value);
+        return true;
+    }
+
+    // Reads the size following a type byte of a 8, 16 or 32 bit sized string, array or map, selected by index 0 to 2.
+    [[nodiscard]] inline bool ReadMsgPackSize(BinaryReader& reader, unsigned index, size_t& size) noexcept
+    {
+        switch (index)
+        {
+            case 0: {
+                std::uint8_t value {};
+                return ReadBigEndian(reader, value) && (size = value, true);
+            }
+            case 1: {
+                std::uint16_t value {};
+                return ReadBigEndian(reader, value) && (size = value, true);
+            }
+            case 2: {
+                std::uint32_t value {};
+                return ReadBigEndian(reader, value) && (size = value, true);
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] inline bool ReadMsgPackStringSize(BinaryReader& reader, std::uint8_t type, size_t& size) noexcept
+    {
+        if ((type & 0xE0) == MsgPackFixStr)
+        {
+            size = type & 0x1F;
+            return true;
+        }
+        return type >= MsgPackStr8 && type <= MsgPackStr8 + 2
+               && ReadMsgPackSize(reader, static_cast<unsigned>(type - MsgPackStr8), size);
+    }
+
+    // Reads the size of an array, or of a map if type is MsgPackFixMap and MsgPackMap16.
+    [[nodiscard]] inline bool ReadMsgPackContainerSize(
+        BinaryReader& reader, std::uint8_t type, std::uint8_t fixType, std::uint8_t type16, size_t& size) noexcept
+    {
+        if ((type & 0xF0) == fixType)
+        {
+            size = type & 0x0F;
+            return true;
+        }
+        return (type == type16 || type == type16 + 1)
+               && ReadMsgPackSize(reader, static_cast<unsigned>(type - type16) + 1, size);
+    }
+
+    // Reads any integer, as its two's complement bits and whether it is negative.
+    [[nodiscard]] inline bool ReadMsgPackInteger(BinaryReader& reader,
+                                                 std::uint8_t type,
+                                                 std::uint64_t& bits,
+                                                 bool& negative) noexcept
+    {
+        negative = false;
+        if (type < 0x80)
+        {
+            bits = type;
+            return true;
+        }
+        if (type >= MsgPackNegativeFixInt)
+        {
+            bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<std::int8_t>(type)));
+            negative = true;
+            return true;
+        }
+        auto const readAs = [&]<typename U>(U value) {
+            if (!ReadBigEndian(reader, value))
+                return false;
+            if constexpr (std::is_signed_v<U>)
+            {
+                negative = value < 0;
+                bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            }
+            else
+                bits = value;
+            return true;
+        };
+        switch (type)
+        {
+            case MsgPackUInt8: return readAs(std::uint8_t {});
+            case MsgPackUInt8 + 1: return readAs(std::uint16_t {});
+            case MsgPackUInt8 + 2: return readAs(std::uint32_t {});
+            case MsgPackUInt8 + 3: return readAs(std::uint64_t {});
+            case MsgPackInt8: return readAs(std::int8_t {});
+            case MsgPackInt8 + 1: return readAs(std::int16_t {});
+            case MsgPackInt8 + 2: return readAs(std::int32_t {});
+            case MsgPackInt8 + 3: return readAs(std::int64_t {});
+            default: return false;
+        }
+    }
+
+    // Converts an integer read by ReadMsgPackInteger, failing if it is out of the range of T.
+    template <typename T>
+    [[nodiscard]] bool FromMsgPackInteger(std::uint64_t bits, bool negative, T& value) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            auto const signedValue = static_cast<std::int64_t>(bits);
+            if (!negative && bits > static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+                return false;
+            if constexpr (sizeof(T) < sizeof(signedValue))
+                if (negative && signedValue < std::numeric_limits<T>::min())
+                    return false;
+            value = static_cast<T>(signedValue);
+        }
+        else
+        {
+            if (negative)
+                return false;
+            if constexpr (sizeof(T) < sizeof(bits))
+                if (bits > std::numeric_limits<T>::max())
+                    return false;
+            value = static_cast<T>(bits);
+        }
+        return true;
+    }
+
+    // Skips a complete value, including all elements of arrays and maps.
+    [[nodiscard]] inline bool SkipMsgPackValue(BinaryReader& reader) noexcept
+    {
+        // Every pending value takes at least one byte, which bounds the count on malformed input.
+        size_t pending = 1;
+        while (pending > 0)
+        {
+            if (pending > reader.remaining())
+                return false;
+            --pending;
+            std::uint8_t type {};
+            if (!reader.Read(type))
+                return false;
+            size_t size = 0;
+            if (type < 0x80 || type >= MsgPackNegativeFixInt || type == MsgPackNil || type == MsgPackFalse
+                || type == MsgPackTrue)
+                continue;
+            if ((type & 0xF0) == MsgPackFixMap || type == MsgPackMap16 || type == MsgPackMap16 + 1)
+            {
+                if (!ReadMsgPackContainerSize(reader, type, MsgPackFixMap, MsgPackMap16, size))
+                    return false;
+                pending += 2 * size;
+            }
+            else if ((type & 0xF0) == MsgPackFixArray || type == MsgPackArray16 || type == MsgPackArray16 + 1)
+            {
+                if (!ReadMsgPackContainerSize(reader, type, MsgPackFixArray, MsgPackArray16, size))
+                    return false;
+                pending += size;
+            }
+            else if ((type & 0xE0) == MsgPackFixStr || (type >= MsgPackStr8 && type <= MsgPackStr8 + 2))
+            {
+                if (!ReadMsgPackStringSize(reader, type, size) || !reader.Skip(size))
+                    return false;
+            }
+            else if (type >= 0xC4 && type <= 0xC6) // bin 8, 16, 32
+            {
+                if (!ReadMsgPackSize(reader, type - 0xC4, size) || !reader.Skip(size))
+                    return false;
+            }
+            else if (type >= 0xC7 && type <= 0xC9) // ext 8, 16, 32, with a type byte after the size
+            {
+                if (!ReadMsgPackSize(reader, type - 0xC7, size) || !reader.Skip(size + 1))
+                    return false;
+            }
+            else if (type >= MsgPackFloat32 && type <= 0xD3) // floats and integers
+            {
+                constexpr auto sizes = std::array<size_t, 10> { 4, 8, 1, 2, 4, 8, 1, 2, 4, 8 };
+                if (!reader.Skip(sizes[type - MsgPackFloat32]))
+                    return false;
+            }
+            else if (type >= 0xD4 && type <= 0xD8) // fixext 1, 2, 4, 8, 16, with a type byte
+            {
+                if (!reader.Skip(1 + (size_t { 1 } << (type - 0xD4))))
+                    return false;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool ReadMsgPackValue(BinaryReader& reader, T& value);
+
+    template <typename T>
+    [[nodiscard]] bool ReadMsgPackValue(BinaryReader& reader, std::uint8_t type, T& value);
+
+    // Lookup from member names to member indices (open addressing, linear probing) and the decoder of every member.
+    template <typename Object>
+    struct MsgPackSchema
+    {
+        using Decoder = bool (*)(BinaryReader&, Object&);
+
+        static constexpr size_t MemberCount = CountMembers<Object>;
+        static constexpr size_t TableSize = std::bit_ceil(MemberCount * 2 + 1);
+        static constexpr std::uint16_t EmptySlot = 0xFFFF;
+
+        static constexpr auto decoders = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<Decoder, MemberCount> { +[](BinaryReader& reader, Object& object) {
+                return ReadMsgPackValue(reader, GetMemberAt<I>(object));
+            }... };
+        }(std::make_index_sequence<MemberCount> {});
+
+        static constexpr auto slots = [] {
+            auto result = std::array<std::uint16_t, TableSize> {};
+            result.fill(EmptySlot);
+            for (size_t i = 0; i < MemberCount; ++i)
+            {
+                auto slot = Fnv1a(MemberNames<Object>[i]) & (TableSize - 1);
+                while (result[slot] != EmptySlot)
+                    slot = (slot + 1) & (TableSize - 1);
+                result[slot] = static_cast<std::uint16_t>(i);
+            }
+            return result;
+        }();
+
+        /// @return the index of the member with the given name, or MemberCount if there is none.
+        /// Members are usually encoded in declaration order, so the member after the previous one is tried first.
+        [[nodiscard]] static constexpr size_t Find(std::string_view name, size_t expected) noexcept
+        {
+            if (expected < MemberCount && MemberNames<Object>[expected] == name)
+                return expected;
+            for (auto slot = Fnv1a(name) & (TableSize - 1);; slot = (slot + 1) & (TableSize - 1))
+            {
+                auto const index = slots[slot];
+                if (index == EmptySlot)
+                    return MemberCount;
+                if (MemberNames<Object>[index] == name)
+                    return index;
+            }
+        }
+    };
+
+    template <typename Object>
+    [[nodiscard]] bool ReadMsgPackObject(BinaryReader& reader, std::uint8_t type, Object& object)
+    {
+        using Schema = MsgPackSchema<Object>;
+        size_t size = 0;
+        if (ReadMsgPackContainerSize(reader, type, MsgPackFixArray, MsgPackArray16, size))
+        {
+            for (size_t i = 0; i < size; ++i)
+                if (!(i < Schema::MemberCount ? Schema::decoders[i](reader, object) : SkipMsgPackValue(reader)))
+                    return false;
+            return true;
+        }
+        if (!ReadMsgPackContainerSize(reader, type, MsgPackFixMap, MsgPackMap16, size))
+            return false;
+        size_t expected = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            std::uint8_t keyType {};
+            size_t keySize = 0;
+            std::span<std::byte const> key;
+            if (!reader.Read(keyType) || !ReadMsgPackStringSize(reader, keyType, keySize) || !reader.Take(keySize, key))
+                return false;
+            auto const index =
+                Schema::Find(std::string_view(reinterpret_cast<char const*>(key.data()), key.size()), expected);
+            if (index < Schema::MemberCount)
+            {
+                if (!Schema::decoders[index](reader, object))
+                    return false;
+                expected = index + 1;
+            }
+            else if (!SkipMsgPackValue(reader))
+                return false;
+        }
+        return true;
+    }
+
+    // Decodes a value whose type byte has already been consumed.
+    template <typename T>
+    [[nodiscard]] bool ReadMsgPackValue(BinaryReader& reader, std::uint8_t type, T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            value = type == MsgPackTrue;
+            return type == MsgPackTrue || type == MsgPackFalse;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            std::uint64_t bits {};
+            bool negative {};
+            std::underlying_type_t<T> underlying {};
+            if (!ReadMsgPackInteger(reader, type, bits, negative) || !FromMsgPackInteger(bits, negative, underlying))
+                return false;
+            value = static_cast<T>(underlying);
+            return true;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            std::uint64_t bits {};
+            bool negative {};
+            return ReadMsgPackInteger(reader, type, bits, negative) && FromMsgPackInteger(bits, negative, value);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            if (type == MsgPackFloat64)
+            {
+                std::uint64_t bits {};
+                return ReadBigEndian(reader, bits) && (value = static_cast<T>(std::bit_cast<double>(bits)), true);
+            }
+            if (type == MsgPackFloat32)
+            {
+                std::uint32_t bits {};
+                return ReadBigEndian(reader, bits) && (value = static_cast<T>(std::bit_cast<float>(bits)), true);
+            }
+            // Writers in dynamic languages encode integral floating point values as integers.
+            std::uint64_t bits {};
+            bool negative {};
+            if (!ReadMsgPackInteger(reader, type, bits, negative))
+                return false;
+            value = negative ? static_cast<T>(static_cast<std::int64_t>(bits)) : static_cast<T>(bits);
+            return true;
+        }
+        else if constexpr (BinaryString<T>)
+        {
+            size_t size = 0;
+            std::span<std::byte const> bytes;
+            if (!ReadMsgPackStringSize(reader, type, size) || !reader.Take(size, bytes))
+                return false;
+            value.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+            return true;
+        }
+        else if constexpr (IsOptional<T>)
+        {
+            if (type == MsgPackNil)
+            {
+                value.reset();
+                return true;
+            }
+            return ReadMsgPackValue(reader, type, value ? *value : value.emplace());
+        }
+        else if constexpr (BinaryVector<T>)
+        {
+            size_t size = 0;
+            if (!ReadMsgPackContainerSize(reader, type, MsgPackFixArray, MsgPackArray16, size))
+                return false;
+            value.clear();
+            // Do not trust the size for preallocation beyond what the input could possibly hold.
+            value.reserve(std::min(size, reader.remaining()));
+            for (size_t i = 0; i < size; ++i)
+                if (!ReadMsgPackValue(reader, value.emplace_back()))
+                    return false;
+            return true;
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>, "Type cannot be decoded from MessagePack");
+            return ReadMsgPackObject(reader, type, value);
+        }
+    }
+
+    template <typename T>
+    [[nodiscard]] bool ReadMsgPackValue(BinaryReader& reader, T& value)
+    {
+        std::uint8_t type {};
+        return reader.Read(type) && ReadMsgPackValue(reader, type, value);
+    }
+} // namespace detail
+
+/// Appends the MessagePack representation of an object to output.
+///
+/// Aggregates are encoded as maps keyed by their member names, whose encoding is computed at compile time,
+/// or as arrays of their members in declaration order. Integers take the smallest encoding that holds their value,
+/// enums are encoded as their underlying value, empty optionals as nil, and vectors as arrays.
+template <MsgPackLayout Layout = MsgPackLayout::Map, typename Object>
+void ToMsgPack(Object const& object, std::vector<std::byte>& output)
+{
+    detail::WriteMsgPackValue<Layout>(output, object);
+}
+
+/// Decodes an object from MessagePack, consuming its bytes from the reader.
+///
+/// Aggregates are accepted in both layouts. Map entries are matched to members by name, unknown entries are skipped,
+/// and members that are not present in the input keep their current value. Integers are accepted in any encoding
+/// whose value fits into the member.
+///
+/// @return false if the input is truncated, malformed, or a value does not match the type of its member
+template <typename Object>
+[[nodiscard]] bool FromMsgPack(BinaryReader& reader, Object& object)
+{
+    return detail::ReadMsgPackValue(reader, object);
+}
+
+template <typename Object>
+[[nodiscard]] bool FromMsgPack(std::span<std::byte const> input, Object& object)
+{
+    auto reader = BinaryReader { input };
+    return FromMsgPack(reader, object);
+}
+
+} // namespace Reflection
@@ -3,12 +3,21 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
 #include <format>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #if __has_include(<source_location>)
@@ -20,6 +29,18 @@
     #define REFLECTION_PRETTY_FUNCTION __FUNCSIG__
 #endif
 
+// Vector instructions used by CollectDifferences, unless disabled with REFLECTION_NO_SIMD.
+#if !defined(REFLECTION_NO_SIMD)
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define REFLECTION_SIMD_AVX2 1
+        #define REFLECTION_SIMD_SSE2 1
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #include <emmintrin.h>
+        #define REFLECTION_SIMD_SSE2 1
+    #endif
+#endif
+
 namespace Reflection
 {
 
@@ -68,6 +89,112 @@ struct StringLiteral
     }
 };
 
+/// String of at most N characters stored inline, e.g. the result of Inspect<FixedCapacity<>>(object).
+///
+/// Appending beyond the capacity truncates, it never allocates.
+template <size_t N>
+class FixedString
+{
+  public:
+    using value_type = char;
+
+    constexpr FixedString() noexcept = default;
+
+    constexpr FixedString(std::string_view text) noexcept
+    {
+        append(text);
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] constexpr size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] constexpr char const* data() const noexcept
+    {
+        return _data;
+    }
+
+    [[nodiscard]] constexpr char const* c_str() const noexcept
+    {
+        return _data;
+    }
+
+    [[nodiscard]] constexpr char const* begin() const noexcept
+    {
+        return _data;
+    }
+
+    [[nodiscard]] constexpr char const* end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    constexpr void clear() noexcept
+    {
+        _size = 0;
+        _data[0] = '\0';
+    }
+
+    constexpr void push_back(char ch) noexcept
+    {
+        if (_size < N)
+        {
+            _data[_size++] = ch;
+            _data[_size] = '\0';
+        }
+    }
+
+    constexpr FixedString& append(std::string_view text) noexcept
+    {
+        auto const count = std::min(text.size(), N - _size);
+        std::copy_n(text.data(), count, _data + _size);
+        _size += count;
+        _data[_size] = '\0';
+        return *this;
+    }
+
+    constexpr FixedString& operator+=(char ch) noexcept
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    constexpr FixedString& operator+=(std::string_view text) noexcept
+    {
+        return append(text);
+    }
+
+    [[nodiscard]] constexpr std::string_view sv() const noexcept
+    {
+        return { _data, _size };
+    }
+
+    [[nodiscard]] constexpr operator std::string_view() const noexcept
+    {
+        return { _data, _size };
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(FixedString const& lhs, std::string_view rhs) noexcept
+    {
+        return lhs.sv() == rhs;
+    }
+
+  private:
+    size_t _size = 0;
+    char _data[N + 1] {};
+};
+
 namespace detail
 {
     template <std::array V>
@@ -102,10 +229,14 @@ inline constexpr auto JoinStringLiterals = detail::join<Strs...>();
 namespace detail
 {
     // This helper-struct is only used by CountMembers to count the number of members in an aggregate type
+    //
+    // The conversion is never defined, and deliberately not constexpr: probing members such as std::optional
+    // instantiates constexpr constructors that call it, and GCC warns about inline (thus constexpr) functions that are
+    // used but never defined.
     struct AnyType final
     {
         template <class T>
-        [[maybe_unused]] constexpr operator T() const;
+        [[maybe_unused]] operator T() const;
     };
 
     template <auto Ptr>
@@ -971,15 +1102,18 @@ namespace detail
     #pragma clang diagnostic ignored "-Weverything"
 
     template <auto N, class T>
-    constexpr std::string_view GetNameImpl = MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
+    inline constexpr std::string_view GetNameImpl =
+        MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
 
     #pragma clang diagnostic pop
 #elif __GNUC__
     template <auto N, class T>
-    constexpr std::string_view GetNameImpl = MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
+    inline constexpr std::string_view GetNameImpl =
+        MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
 #else
     template <auto N, class T>
-    constexpr std::string_view GetNameImpl = MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
+    inline constexpr std::string_view GetNameImpl =
+        MangledName<GetElementPtrAt<N>(External<std::remove_volatile_t<T>>)>();
 #endif
 
     struct REFLE_REFLECTOR
@@ -1005,6 +1139,8 @@ namespace detail
 #endif
     };
 
+    // Extracts the member name out of the prettified function signature.
+    // Only ever evaluated at compile time, the signature itself must not end up in the binary.
     template <auto N, class T>
     struct MemberNameOfImpl
     {
@@ -1012,29 +1148,66 @@ namespace detail
         static constexpr auto begin = name.find(reflect_field::end);
         static constexpr auto tmp = name.substr(0, begin);
         static constexpr auto stripped = tmp.substr(tmp.find_last_of(reflect_field::begin) + 1);
+    };
+
+    // Storage of all member names of T in one contiguous character blob, with an offset table into it.
+    // This keeps a single static array per type instead of one per member.
+    template <class T>
+    struct MemberNameStorage
+    {
+        static constexpr size_t count = CountMembers<T>;
+
+        static constexpr auto offsets = []<size_t... I>(std::index_sequence<I...>) {
+            auto result = std::array<size_t, count + 1> {};
+            size_t i = 0;
+            ((result[i + 1] = result[i] + MemberNameOfImpl<I, T>::stripped.size(), ++i), ...);
+            return result;
+        }(std::make_index_sequence<count> {});
+
+        static constexpr auto blob = []<size_t... I>(std::index_sequence<I...>) {
+            auto result = std::array<char, offsets[count]> {};
+            size_t i = 0;
+            auto const append = [&](std::string_view name) {
+                for (auto const c: name)
+                    result[i++] = c;
+            };
+            (append(MemberNameOfImpl<I, T>::stripped), ...);
+            return result;
+        }(std::make_index_sequence<count> {});
+
+        static constexpr auto names = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<std::string_view, count> { std::string_view {
+                blob.data() + offsets[I], offsets[I + 1] - offsets[I] }... };
+        }(std::make_index_sequence<count> {});
+    };
+
+    template <class T>
+    struct TypeNameOfImpl
+    {
+        static constexpr std::string_view name = MangledName<T>();
+        static constexpr auto begin = name.find(reflect_type::end);
+        static constexpr auto tmp = name.substr(0, begin);
+#if defined(__GNUC__) || defined(__clang__)
+        static constexpr auto stripped = tmp.substr(tmp.rfind(reflect_type::begin) + reflect_type::begin.size());
+#else
+        static constexpr auto name_with_keyword =
+            tmp.substr(tmp.rfind(reflect_type::begin) + reflect_type::begin.size());
+        static constexpr auto stripped = name_with_keyword.substr(name_with_keyword.find(' ') + 1);
+#endif
         // Making static memory to stripped to help the compiler optimize away prettified function signature
         static constexpr std::string_view stripped_literal = JoinStringLiterals<stripped>;
     };
 } // namespace detail
 
+/// Names of all members of T, as views into a single static character blob.
+template <class T>
+inline constexpr auto MemberNames = detail::MemberNameStorage<std::remove_cvref_t<T>>::names;
+
 template <auto N, class T>
-inline constexpr auto MemberNameOf = []() constexpr {
-    return detail::MemberNameOfImpl<N, T>::stripped_literal;
-}();
+inline constexpr std::string_view MemberNameOf = MemberNames<T>[N];
 
 template <class T>
-constexpr auto TypeNameOf = [] {
-    constexpr std::string_view name = detail::MangledName<T>();
-    constexpr auto begin = name.find(detail::reflect_type::end);
-    constexpr auto tmp = name.substr(0, begin);
-#if defined(__GNUC__) || defined(__clang__)
-    return tmp.substr(tmp.rfind(detail::reflect_type::begin) + detail::reflect_type::begin.size());
-#else
-    constexpr auto name_with_keyword =
-        tmp.substr(tmp.rfind(detail::reflect_type::begin) + detail::reflect_type::begin.size());
-    return name_with_keyword.substr(name_with_keyword.find(' ') + 1);
-#endif
-}();
+constexpr std::string_view TypeNameOf = detail::TypeNameOfImpl<T>::stripped_literal;
 
 namespace detail
 {
@@ -1054,27 +1227,6 @@ namespace detail
 template <auto P>
 using MemberClassType = typename detail::MemberClassTypeHelper<decltype(P)>::type;
 
-namespace detail
-{
-    template <class T, size_t... I>
-    [[nodiscard]] constexpr auto MemberNamesImpl(std::index_sequence<I...>)
-    {
-        if constexpr (sizeof...(I) == 0)
-        {
-            return std::array<std::string_view, 0> {};
-        }
-        else
-        {
-            return std::array { MemberNameOf<I, T>... };
-        }
-    }
-} // namespace detail
-
-template <class T>
-inline constexpr auto MemberNames = [] {
-    return detail::MemberNamesImpl<T>(std::make_index_sequence<CountMembers<T>> {});
-}();
-
 namespace detail
 {
 
@@ -1205,26 +1357,74 @@ namespace detail
     }
 } // namespace detail
 
+namespace detail
+{
+    template <auto V>
+    struct NameOfImpl
+    {
+        static constexpr std::string_view name = GetName<V>();
+        // Making static memory to name to help the compiler optimize away prettified function signature
+        static constexpr std::string_view literal = JoinStringLiterals<name>;
+    };
+} // namespace detail
+
 /// Gets the name of a member or function pointer
 template <auto V>
-constexpr std::string_view NameOf = detail::GetName<V>();
+constexpr std::string_view NameOf = detail::NameOfImpl<V>::literal;
 
 namespace detail
 {
+    // Index of the member of T of type M at the given address within External<T>.
+    //
+    // The addresses must not leave constant evaluation: a constexpr variable holding them would odr-use the never
+    // defined External<T> and fail to link in unoptimized builds. Hence queries share this function instead of a
+    // table of member addresses. The type is a template parameter rather than the address of a tag variable, as GCC
+    // does not accept comparing such addresses in constant expressions with -fsanitize=undefined.
+    template <typename T, typename M>
+    consteval size_t MemberIndexAt(void const* address)
+    {
+        auto const members = ToTuple(External<T>);
+        using Members = decltype(members);
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            size_t index = 0;
+            (void) (((std::is_same_v<std::remove_cvref_t<std::tuple_element_t<I, Members>>, M>
+                      && static_cast<void const*>(std::addressof(std::get<I>(members))) == address)
+                     && ((index = I), true))
+                    || ...);
+            return index;
+        }(std::make_index_sequence<CountMembers<T>> {});
+    }
+
     // private helper for implementing MemberIndexOf<P>
+    //
+    // Looks up the address P refers to within External<T> among the member addresses of T. Unlike matching member
+    // names, this needs no name extraction, and queries for members of the same type share one lookup.
+    // The type is compared as well, as empty [[no_unique_address]] members may share their address with another one.
+    template <auto P>
+    consteval size_t MemberIndexHelperImpl()
+    {
+        using Object = MemberClassType<P>;
+        return MemberIndexAt<Object, std::remove_cvref_t<decltype(External<Object>.*P)>>(
+            static_cast<void const*>(std::addressof(External<Object>.*P)));
+    }
+
+    // The former name matching implementation of MemberIndexOf, kept for comparison in the compile-time profile.
     template <auto P, size_t... I>
-    consteval size_t MemberIndexHelperImpl(std::index_sequence<I...>)
+    consteval size_t MemberIndexByNameHelperImpl(std::index_sequence<I...>)
     {
         return (((NameOf<P> == MemberNames<MemberClassType<P>>[I]) ? I : 0) + ...);
     }
+
+    template <auto P>
+    constexpr size_t MemberIndexOfByName =
+        MemberIndexByNameHelperImpl<P>(std::make_index_sequence<CountMembers<MemberClassType<P>>> {});
 } // namespace detail
 
 /// Gets the index of a member pointer in the member list of its class
 ///
 /// @tparam P The member pointer, e.g. &MyClass::member
 template <auto P>
-constexpr size_t MemberIndexOf =
-    detail::MemberIndexHelperImpl<P>(std::make_index_sequence<CountMembers<MemberClassType<P>>> {});
+constexpr size_t MemberIndexOf = detail::MemberIndexHelperImpl<P>();
 
 /// Calls a callable on members of an object specified with ElementMask sequence with the index of the member as the
 /// first argument. and the member's default-constructed value as the second argument.
@@ -1321,56 +1521,670 @@ constexpr ResultType FoldMembers(Object& object, ResultType initialValue, Callab
     // clang-format on
 }
 
-template <typename Object>
-std::string Inspect(Object const& object)
+namespace detail
 {
-    std::string str;
-    auto const onMember = [&str]<typename Name, typename Value>(Name&& name, Value&& value) {
-        auto const InspectValue = [&str]<typename T>(T&& arg) {
-            // clang-format off
-            if constexpr (std::is_convertible_v<T, std::string>
-                       || std::is_convertible_v<T, std::string_view>
-                       || std::is_convertible_v<T, char const*>) // clang-format on
+    // Index of the member of Source that has the same name as the member I of Target,
+    // or CountMembers<Source> if there is none.
+    template <typename Target, typename Source, size_t I>
+    constexpr size_t SourceMemberIndexOf = [] {
+        constexpr auto names = MemberNames<Source>;
+        for (size_t j = 0; j < names.size(); ++j)
+            if (names[j] == MemberNameOf<I, Target>)
+                return j;
+        return names.size();
+    }();
+
+    template <typename Target, typename Source>
+    constexpr bool HasSameMembersInOrder = []<size_t... I>(std::index_sequence<I...>) {
+        if constexpr (CountMembers<Target> != CountMembers<Source>)
+            return false;
+        else
+            return ((SourceMemberIndexOf<Target, Source, I> == I
+                     && std::same_as<MemberTypeOf<I, Target>, MemberTypeOf<I, Source>>)
+                    && ...);
+    }(std::make_index_sequence<CountMembers<Target>> {});
+} // namespace detail
+
+/// Tests whether two distinct aggregates have the same members (by name and type) in the same order
+/// and are trivially copyable standard layout types, i.e. whether one can be copied to the other as raw bytes.
+template <typename Target, typename Source>
+constexpr bool HasIdenticalLayout = [] {
+    using T = std::remove_cvref_t<Target>;
+    using S = std::remove_cvref_t<Source>;
+    if constexpr (!std::is_trivially_copyable_v<T> || !std::is_trivially_copyable_v<S>
+                  || !std::is_standard_layout_v<T> || !std::is_standard_layout_v<S>
+                  || sizeof(T) != sizeof(S) || alignof(T) != alignof(S))
+        return false;
+    else
+        return detail::HasSameMembersInOrder<T, S>;
+}();
+
+/// Conversions AssignByName may apply between members of the same name but of different types.
+enum class MemberConversion
+{
+    /// Only identical or implicitly assignable non-arithmetic types are assigned.
+    None,
+    /// Arithmetic members are additionally converted with static_cast.
+    Arithmetic,
+};
+
+/// Assigns every member of target from the member of source with the same name.
+///
+/// The mapping between members is computed at compile time, so this compiles down to straight-line
+/// copies (or moves, if source is an rvalue) of the matched members. Target members without a counterpart
+/// in source are left untouched, nested aggregates of different types are assigned recursively by name.
+/// If both types have an identical layout, the whole object is copied with a single memcpy.
+///
+/// @tparam Conversion the conversions allowed between members of different types
+template <MemberConversion Conversion = MemberConversion::None, typename Target, typename Source>
+constexpr void AssignByName(Target& target, Source&& source)
+{
+    using S = std::remove_cvref_t<Source>;
+    constexpr bool moveMembers = !std::is_lvalue_reference_v<Source>;
+
+    if constexpr (HasIdenticalLayout<Target, S> && !std::same_as<Target, S>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            std::memcpy(static_cast<void*>(&target), static_cast<void const*>(&source), sizeof(Target));
+            return;
+        }
+    }
+
+    template_for<0, CountMembers<Target>>([&]<auto I>() {
+        constexpr auto J = detail::SourceMemberIndexOf<Target, S, I>;
+        if constexpr (J < CountMembers<S>)
+        {
+            using TargetMember = MemberTypeOf<I, Target>;
+            using SourceMember = MemberTypeOf<J, S>;
+            auto& to = GetMemberAt<I>(target);
+            auto&& from = [&]() -> decltype(auto) {
+                if constexpr (moveMembers)
+                    return std::move(GetMemberAt<J>(source));
+                else
+                    return std::as_const(GetMemberAt<J>(source));
+            }();
+
+            if constexpr (std::same_as<TargetMember, SourceMember>)
+                to = std::forward<decltype(from)>(from);
+            else if constexpr (std::is_arithmetic_v<TargetMember> && std::is_arithmetic_v<SourceMember>)
             {
-                str += std::format("\"{}\"", arg);
+                static_assert(Conversion == MemberConversion::Arithmetic,
+                              "Members of the same name have different arithmetic types, "
+                              "use MemberConversion::Arithmetic to convert them");
+                to = static_cast<TargetMember>(from);
             }
-            else if constexpr (std::is_convertible_v<T, int>) // use std::formattable when available
+            else if constexpr (std::is_aggregate_v<TargetMember> && std::is_aggregate_v<SourceMember>)
+                AssignByName<Conversion>(to, std::forward<decltype(from)>(from));
+            else
             {
-                str += std::format("{}", arg);
+                static_assert(std::is_assignable_v<TargetMember&, decltype(from)>,
+                              "Members of the same name have incompatible types");
+                to = std::forward<decltype(from)>(from);
             }
+        }
+    });
+}
+
+namespace detail
+{
+    inline constexpr size_t UnlimitedStringLength = std::numeric_limits<size_t>::max();
+
+    template <typename T>
+    concept InspectStringLike = std::is_convertible_v<T const&, std::string>
+                                || std::is_convertible_v<T const&, std::string_view>
+                                || std::is_convertible_v<T const&, char const*>;
+
+    template <typename T>
+    constexpr bool IsOptional = false;
+
+    template <typename T>
+    constexpr bool IsOptional<std::optional<T>> = true;
+
+    template <typename T>
+    constexpr bool IsVariant = false;
+
+    template <typename... T>
+    constexpr bool IsVariant<std::variant<T...>> = true;
+
+    template <typename T>
+    concept InspectMap = std::ranges::range<T const> && requires {
+        typename T::key_type;
+        typename T::mapped_type;
+    };
+
+    template <typename T>
+    concept InspectTupleLike = requires { std::tuple_size<T>::value; };
+
+    // Values printed member by member as name=value pairs, rather than as a scalar, string or container.
+    template <typename T>
+    concept InspectRecord = !InspectStringLike<T> && !std::is_enum_v<T> && !std::is_convertible_v<T const&, int>
+                            && !IsOptional<T> && !IsVariant<T> && !std::ranges::range<T const>
+                            && !InspectTupleLike<T>;
+
+    constexpr size_t DecimalDigits(size_t value) noexcept
+    {
+        size_t digits = 1;
+        while (value >= 10)
+        {
+            value /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+    // Upper bound of the number of characters std::format("{}", value) produces for an arithmetic value.
+    template <typename T>
+    constexpr size_t FormattedWidth()
+    {
+        using Limits = std::numeric_limits<T>;
+        if constexpr (std::is_same_v<T, bool>)
+            return 5; // false
+        else if constexpr (std::is_same_v<T, char>)
+            return 1;
+        else if constexpr (std::is_integral_v<T>)
+            return Limits::digits10 + 1 + (Limits::is_signed ? 1 : 0);
+        else
+        {
+            // sign, digits, decimal point, 'e', exponent sign and exponent digits, down to the smallest subnormal
+            constexpr size_t exponent = std::max(Limits::max_exponent10, Limits::max_digits10 - Limits::min_exponent10);
+            return 1 + Limits::max_digits10 + 1 + 2 + DecimalDigits(exponent);
+        }
+    }
+
+    // Estimate of the number of characters InspectValueTo appends for value, to reserve the output once.
+    //
+    // Numbers are assumed at their widest, and ranges of numbers are estimated from their size without visiting them.
+    template <typename T>
+    size_t EstimateInspectSize(T const& value)
+    {
+        if constexpr (InspectStringLike<T>)
+        {
+            if constexpr (std::is_convertible_v<T const&, std::string_view>)
+                return std::string_view(value).size() + 2;
+            else
+                return 16;
+        }
+        else if constexpr (std::is_enum_v<T>)
+            return FormattedWidth<std::underlying_type_t<T>>();
+        else if constexpr (std::is_arithmetic_v<T>)
+            return FormattedWidth<T>();
+        else if constexpr (std::is_convertible_v<T const&, int>)
+            return FormattedWidth<int>();
+        else if constexpr (IsOptional<T>)
+            return value ? EstimateInspectSize(*value) : 4;
+        else if constexpr (IsVariant<T>)
+        {
+            if (value.valueless_by_exception())
+                return 4;
+            return std::visit([](auto const& alternative) { return EstimateInspectSize(alternative); }, value);
+        }
+        else if constexpr (InspectMap<T>)
+        {
+            size_t size = 2;
+            for (auto const& [key, mapped]: value)
+                size += EstimateInspectSize(key) + 2 + EstimateInspectSize(mapped) + 2;
+            return size;
+        }
+        else if constexpr (std::ranges::range<T const>)
+        {
+            using Element = std::remove_cvref_t<std::ranges::range_reference_t<T const>>;
+            if constexpr (std::is_arithmetic_v<Element> && std::ranges::sized_range<T const>)
+                return 2 + static_cast<size_t>(std::ranges::size(value)) * (FormattedWidth<Element>() + 2);
             else
             {
-                str += '{';
-                str += Inspect(arg);
-                str += '}';
+                size_t size = 2;
+                for (auto const& element: value)
+                    size += EstimateInspectSize(element) + 2;
+                return size;
             }
-        };
-        if (!str.empty())
-            str += ' ';
-        str += name;
-        str += '=';
-        InspectValue(value);
-    };
+        }
+        else if constexpr (InspectTupleLike<T>)
+            return std::apply(
+                [](auto const&... elements) { return (size_t { 2 } + ... + (EstimateInspectSize(elements) + 2)); },
+                value);
+        else
+        {
+            size_t size = 2;
+            EnumerateMembers(value, [&]<size_t I>(auto const& member) {
+                size += MemberNameOf<I, T>.size() + 2 + EstimateInspectSize(member);
+            });
+            return size;
+        }
+    }
 
-    CallOnMembers(object, onMember);
-    return str;
+    template <size_t MaxStringLength, typename String, typename Object>
+    void InspectMembersTo(String& output, Object const& object);
+
+    // Appends a single value: strings quoted, numbers as they are, and containers, tuples and nested records enclosed
+    // in brackets. Prints at most MaxStringLength characters of each string.
+    template <size_t MaxStringLength, typename String, typename T>
+    void InspectValueTo(String& output, T const& value)
+    {
+        if constexpr (InspectStringLike<T>)
+        {
+            if constexpr (MaxStringLength != UnlimitedStringLength)
+            {
+                auto const text = std::string_view(value).substr(0, MaxStringLength);
+                std::format_to(std::back_inserter(output), "\"{}\"", text);
+            }
+            else
+                std::format_to(std::back_inserter(output), "\"{}\"", value);
+        }
+        else if constexpr (std::is_enum_v<T>)
+            std::format_to(std::back_inserter(output), "{}", static_cast<std::underlying_type_t<T>>(value));
+        else if constexpr (std::is_convertible_v<T const&, int>) // use std::formattable when available
+            std::format_to(std::back_inserter(output), "{}", value);
+        else if constexpr (IsOptional<T>)
+        {
+            if (value)
+                InspectValueTo<MaxStringLength>(output, *value);
+            else
+                output += "null";
+        }
+        else if constexpr (IsVariant<T>)
+        {
+            if (value.valueless_by_exception())
+                output += "null";
+            else
+                std::visit([&](auto const& alternative) { InspectValueTo<MaxStringLength>(output, alternative); },
+                           value);
+        }
+        else if constexpr (InspectMap<T>)
+        {
+            output += '{';
+            bool first = true;
+            for (auto const& [key, mapped]: value)
+            {
+                if (!first)
+                    output += ", ";
+                first = false;
+                InspectValueTo<MaxStringLength>(output, key);
+                output += ": ";
+                InspectValueTo<MaxStringLength>(output, mapped);
+            }
+            output += '}';
+        }
+        else if constexpr (std::ranges::range<T const>)
+        {
+            output += '[';
+            bool first = true;
+            for (auto const& element: value)
+            {
+                if (!first)
+                    output += ", ";
+                first = false;
+                InspectValueTo<MaxStringLength>(output, element);
+            }
+            output += ']';
+        }
+        else if constexpr (InspectTupleLike<T>)
+        {
+            output += '(';
+            std::apply(
+                [&](auto const&... elements) {
+                    bool first = true;
+                    auto const inspect = [&](auto const& element) {
+                        if (!first)
+                            output += ", ";
+                        first = false;
+                        InspectValueTo<MaxStringLength>(output, element);
+                    };
+                    (inspect(elements), ...);
+                },
+                value);
+            output += ')';
+        }
+        else
+        {
+            output += '{';
+            InspectMembersTo<MaxStringLength>(output, value);
+            output += '}';
+        }
+    }
+
+    template <size_t MaxStringLength, typename String, typename Object>
+    void InspectMembersTo(String& output, Object const& object)
+    {
+        bool first = true;
+        CallOnMembers(object, [&output, &first](std::string_view name, auto const& value) {
+            if (!first)
+                output += ' ';
+            first = false;
+            output += name;
+            output += '=';
+            InspectValueTo<MaxStringLength>(output, value);
+        });
+    }
+
+    // Reserves room for size more characters, growing geometrically, such that appending many objects to one buffer
+    // takes amortized constant time per character also with implementations whose reserve does not round up.
+    template <typename String>
+    void ReserveInspectOutput(String& output, size_t size)
+    {
+        if constexpr (requires { output.reserve(size), output.capacity(); })
+            if (output.capacity() - output.size() < size)
+                output.reserve(std::max(output.size() + size, 2 * output.capacity()));
+    }
+} // namespace detail
+
+/// Appends a human readable representation of the object's members to output.
+///
+/// Members may be strings, numbers, enums, nested records, any range (printed as [a, b]), associative containers
+/// (printed as {key: value}), std::pair and std::tuple (printed as (a, b)), std::optional (empty as null) and
+/// std::variant (printed as its held alternative). Values other than records are printed the same way.
+///
+/// The output can be any std::basic_string-like buffer (e.g. with a custom allocator). Its growth is reserved once
+/// from an estimate of the output size, and nothing is allocated if it has sufficient capacity.
+template <typename String, typename Object>
+void InspectTo(String& output, Object const& object)
+{
+    detail::ReserveInspectOutput(output, detail::EstimateInspectSize(object));
+    if constexpr (detail::InspectRecord<Object>)
+        detail::InspectMembersTo<detail::UnlimitedStringLength>(output, object);
+    else
+        detail::InspectValueTo<detail::UnlimitedStringLength>(output, object);
+}
+
+/// Appends the representation of each object on its own line.
+template <typename String, typename Object>
+void InspectTo(String& output, std::vector<Object> const& objects)
+{
+    size_t size = 0;
+    for (auto const& object: objects)
+        size += detail::EstimateInspectSize(object) + 1;
+    detail::ReserveInspectOutput(output, size);
+    for (auto const& object: objects)
+    {
+        if constexpr (detail::InspectRecord<Object>)
+            detail::InspectMembersTo<detail::UnlimitedStringLength>(output, object);
+        else
+            detail::InspectValueTo<detail::UnlimitedStringLength>(output, object);
+        output += '\n';
+    }
+}
+
+/// A policy of the Inspect family of functions.
+///
+/// It provides the allocator of the resulting string as allocator_type, and may provide a class template
+/// Scope<Object> that is instantiated around each call, e.g. for instrumentation.
+template <typename Policy>
+concept InspectPolicy = requires { typename Policy::allocator_type; };
+
+/// The default Inspect policy, using std::allocator and no instrumentation.
+struct DefaultInspectPolicy
+{
+    using allocator_type = std::allocator<char>;
+};
+
+template <InspectPolicy Policy>
+using InspectString = std::basic_string<char, std::char_traits<char>, typename Policy::allocator_type>;
+
+/// Inspects an object (or a vector of objects) into a string using the given policy.
+template <InspectPolicy Policy, typename Object>
+InspectString<Policy> Inspect(Object const& object)
+{
+    if constexpr (requires { typename Policy::template Scope<Object>; })
+    {
+        [[maybe_unused]] auto const scope = typename Policy::template Scope<Object> {};
+        auto str = InspectString<Policy> {};
+        InspectTo(str, object);
+        return str;
+    }
+    else
+    {
+        auto str = InspectString<Policy> {};
+        InspectTo(str, object);
+        return str;
+    }
+}
+
+template <typename Object>
+std::string Inspect(Object const& object)
+{
+    return Inspect<DefaultInspectPolicy>(object);
 }
 
 template <typename Object>
 std::string Inspect(std::vector<Object> const& objects)
 {
-    std::string str;
-    for (auto const& object: objects)
+    return Inspect<DefaultInspectPolicy>(objects);
+}
+
+/// Selects the Inspect overload returning a FixedString, e.g. Inspect<FixedCapacity<32>>(object).
+///
+/// String members of unbounded length (e.g. std::string) are cut to MaxStringLength characters.
+/// With the default of zero they are not cut, but then no bound is known for objects containing them.
+template <size_t MaxStringLength = 0>
+struct FixedCapacity
+{
+    static constexpr size_t maxStringLength = MaxStringLength;
+};
+
+namespace detail
+{
+    template <typename T>
+    constexpr bool IsFixedCapacity = false;
+
+    template <size_t MaxStringLength>
+    constexpr bool IsFixedCapacity<FixedCapacity<MaxStringLength>> = true;
+
+    inline constexpr size_t UnknownInspectWidth = std::numeric_limits<size_t>::max();
+
+    template <typename T>
+    constexpr size_t InlineStringCapacity = UnknownInspectWidth;
+
+    template <size_t N>
+    constexpr size_t InlineStringCapacity<FixedString<N>> = N;
+
+    template <size_t N>
+    constexpr size_t InlineStringCapacity<StringLiteral<N>> = StringLiteral<N>::length;
+
+    template <typename Object, size_t MaxStringLength>
+    constexpr size_t InspectWidthOf();
+
+    // Upper bound of the characters InspectTo prints for a member of type T, or UnknownInspectWidth.
+    template <typename T, size_t MaxStringLength>
+    constexpr size_t InspectValueWidth()
+    {
+        if constexpr (InspectStringLike<T>)
+        {
+            constexpr auto capacity = InlineStringCapacity<T> != UnknownInspectWidth ? InlineStringCapacity<T>
+                                      : MaxStringLength != 0                         ? MaxStringLength
+                                                                                     : UnknownInspectWidth;
+            return capacity != UnknownInspectWidth ? capacity + 2 : UnknownInspectWidth;
+        }
+        else if constexpr (std::is_enum_v<T>)
+            return FormattedWidth<std::underlying_type_t<T>>();
+        else if constexpr (std::is_arithmetic_v<T>)
+            return FormattedWidth<T>();
+        else if constexpr (IsOptional<T>)
+        {
+            constexpr auto width = InspectValueWidth<typename T::value_type, MaxStringLength>();
+            return width != UnknownInspectWidth ? std::max<size_t>(width, 4) : UnknownInspectWidth;
+        }
+        else if constexpr (InspectRecord<T> && std::is_aggregate_v<T>)
+        {
+            constexpr auto width = InspectWidthOf<T, MaxStringLength>();
+            return width != UnknownInspectWidth ? width + 2 : UnknownInspectWidth;
+        }
+        else
+            return UnknownInspectWidth;
+    }
+
+    template <typename Object, size_t MaxStringLength>
+    constexpr size_t InspectWidthOf()
     {
-        str += Inspect(object);
-        str += '\n';
+        size_t width = CountMembers<Object> > 0 ? CountMembers<Object> - 1 : 0;
+        bool known = true;
+        template_for<0, CountMembers<Object>>([&]<auto I>() {
+            constexpr auto valueWidth = InspectValueWidth<MemberTypeOf<I, Object>, MaxStringLength>();
+            if constexpr (valueWidth == UnknownInspectWidth)
+                known = false;
+            else
+                width += MemberNameOf<I, Object>.size() + 1 + valueWidth;
+        });
+        return known ? width : UnknownInspectWidth;
+    }
+} // namespace detail
+
+/// Inspects an object into a FixedString large enough for any value of Object, so that no heap allocation happens.
+///
+/// Falls back to Inspect(object) returning a std::string if no bound is known, e.g. for uncut std::string members.
+template <typename Capacity, typename Object>
+    requires detail::IsFixedCapacity<Capacity>
+auto Inspect(Object const& object)
+{
+    constexpr auto width = detail::InspectWidthOf<Object, Capacity::maxStringLength>();
+    if constexpr (width == detail::UnknownInspectWidth)
+        return Inspect(object);
+    else
+    {
+        constexpr auto maxStringLength =
+            Capacity::maxStringLength != 0 ? Capacity::maxStringLength : detail::UnlimitedStringLength;
+        auto output = FixedString<width> {};
+        detail::InspectMembersTo<maxStringLength>(output, object);
+        return output;
     }
-    return str;
 }
 
+namespace detail
+{
+    // Members whose equality is exactly the equality of their object representation.
+    template <typename T>
+    concept BytewiseComparable = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+    // Objects that can be compared as a whole block of bytes: padding-free and made of bytewise comparable members
+    // only, so that the offset of every member is the sum of the sizes of the members before it.
+    template <typename Object>
+    constexpr bool IsBytewiseComparable = [] {
+        if constexpr (!std::is_aggregate_v<Object> || !std::is_standard_layout_v<Object>
+                      || !std::has_unique_object_representations_v<Object>)
+            return false;
+        else
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (BytewiseComparable<MemberTypeOf<I, Object>> && ...)
+                       && (sizeof(MemberTypeOf<I, Object>) + ... + 0) == sizeof(Object);
+            }(std::make_index_sequence<CountMembers<Object>> {});
+    }();
+
+    // Index of the member every byte of a bytewise comparable object belongs to.
+    template <typename Object>
+    constexpr auto MemberIndexOfByte = [] {
+        auto table = std::array<std::uint16_t, sizeof(Object)> {};
+        size_t offset = 0;
+        template_for<0, CountMembers<Object>>([&]<auto I>() {
+            for (size_t i = 0; i < sizeof(MemberTypeOf<I, Object>); ++i)
+                table[offset++] = static_cast<std::uint16_t>(I);
+        });
+        return table;
+    }();
+
+    // Offset one past the last byte of every member of a bytewise comparable object.
+    template <typename Object>
+    constexpr auto MemberEndOffsets = [] {
+        auto table = std::array<std::uint32_t, CountMembers<Object>> {};
+        size_t offset = 0;
+        template_for<0, CountMembers<Object>>([&]<auto I>() {
+            offset += sizeof(MemberTypeOf<I, Object>);
+            table[I] = static_cast<std::uint32_t>(offset);
+        });
+        return table;
+    }();
+
+    template <typename Object>
+    using MemberBitset = std::array<std::uint64_t, (CountMembers<Object> + 63) / 64>;
+
+    // Compares two bytewise comparable objects block by block and returns the set of members that differ.
+    template <typename Object>
+    MemberBitset<Object> DifferingMembers(Object const& lhs, Object const& rhs) noexcept
+    {
+        constexpr size_t Size = sizeof(Object);
+        auto const* a = reinterpret_cast<unsigned char const*>(std::addressof(lhs));
+        auto const* b = reinterpret_cast<unsigned char const*>(std::addressof(rhs));
+        auto differing = MemberBitset<Object> {};
+
+        // Marks the members of all differing bytes, bit k of mask standing for the byte at base + k.
+        auto const mark = [&](size_t base, std::uint64_t mask) {
+            while (mask != 0)
+            {
+                auto const member = MemberIndexOfByte<Object>[base + static_cast<size_t>(std::countr_zero(mask))];
+                differing[member / 64] |= std::uint64_t { 1 } << (member % 64);
+                auto const end = MemberEndOffsets<Object>[member] - base;
+                mask = end < 64 ? mask & (~std::uint64_t { 0 } << end) : 0;
+            }
+        };
+
+        size_t i = 0;
+#if defined(REFLECTION_SIMD_AVX2)
+        for (; i + 32 <= Size; i += 32)
+        {
+            auto const equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i)),
+                                                 _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i)));
+            mark(i, ~static_cast<std::uint32_t>(_mm256_movemask_epi8(equal)));
+        }
+#endif
+#if defined(REFLECTION_SIMD_SSE2)
+        for (; i + 16 <= Size; i += 16)
+        {
+            auto const equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i)),
+                                              _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i)));
+            mark(i, ~static_cast<std::uint32_t>(_mm_movemask_epi8(equal)) & 0xFFFFu);
+        }
+#endif
+        for (; i + 8 <= Size; i += 8)
+        {
+            std::uint64_t x {};
+            std::uint64_t y {};
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (x == y)
+                continue;
+            std::uint64_t mask = 0;
+            for (size_t k = 0; k < 8; ++k)
+                mask |= std::uint64_t { a[i + k] != b[i + k] } << k;
+            mark(i, mask);
+        }
+        for (; i < Size; ++i)
+            if (a[i] != b[i])
+                mark(i, 1);
+
+        return differing;
+    }
+
+    // Invokes callback with the index of every differing member, in declaration order,
+    // dispatching through a table such that the cost is proportional to the number of differing members.
+    template <typename Object, typename Callback>
+    void ForEachDifferingMember(Object const& lhs, Object const& rhs, Callback const& callback)
+    {
+        constexpr auto dispatch = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<void (*)(Callback const&), sizeof...(I)> {
+                [](Callback const& f) { f.template operator()<I>(); }...
+            };
+        }(std::make_index_sequence<CountMembers<Object>> {});
+
+        auto const differing = DifferingMembers(lhs, rhs);
+        for (size_t word = 0; word < differing.size(); ++word)
+            for (auto bits = differing[word]; bits != 0; bits &= bits - 1)
+                dispatch[word * 64 + static_cast<size_t>(std::countr_zero(bits))](callback);
+    }
+} // namespace detail
+
+/// Invokes callback with the name and both values of every member that differs between lhs and rhs.
+///
+/// Nested aggregates without an equality operator are compared member-wise.
+/// Objects made only of integral, enum and pointer members without padding are compared as whole byte blocks,
+/// using SSE2 or AVX2 where available, and the callback is invoked for the differing members only.
 template <typename Object, typename Callback>
 void CollectDifferences(const Object& lhs, const Object& rhs, Callback const& callback)
 {
+    if constexpr (detail::IsBytewiseComparable<Object>)
+    {
+        detail::ForEachDifferingMember(lhs, rhs, [&]<size_t I>() {
+            callback(MemberNameOf<I, Object>, GetMemberAt<I>(lhs), GetMemberAt<I>(rhs));
+        });
+        return;
+    }
     template_for<0, CountMembers<Object>>([&]<auto I>() {
         if constexpr (std::equality_comparable<MemberTypeOf<I, Object>>)
         {
@@ -1391,6 +2205,12 @@ template <typename Object, typename Callback>
                           std::invoke_result_t<Callback, size_t, MemberTypeOf<0, Object>, MemberTypeOf<0, Object>>>
 void CollectDifferences(const Object& lhs, const Object& rhs, Callback const& callback)
 {
+    if constexpr (detail::IsBytewiseComparable<Object>)
+    {
+        detail::ForEachDifferingMember(
+            lhs, rhs, [&]<size_t I>() { callback(I, GetMemberAt<I>(lhs), GetMemberAt<I>(rhs)); });
+        return;
+    }
     template_for<0, CountMembers<Object>>([&]<auto I>() {
         if constexpr (std::equality_comparable<MemberTypeOf<I, Object>>)
         {
@@ -1416,3 +2236,12 @@ struct std::formatter<Reflection::StringLiteral<N>>: std::formatter<std::string_
         return formatter<std::string_view>::format(value.sv(), ctx);
     }
 };
+
+template <std::size_t N>
+struct std::formatter<Reflection::FixedString<N>>: std::formatter<std::string_view>
+{
+    auto format(Reflection::FixedString<N> const& value, auto& ctx) const
+    {
+        return formatter<std::string_view>::format(value.sv(), ctx);
+    }
+};
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <reflection-cpp/reflection.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Reflection
+{
+
+namespace detail
+{
+    template <typename M>
+    constexpr bool SeqLockAtomic = [] {
+        if constexpr (std::is_array_v<M>)
+            return false;
+        else
+            return std::atomic<M>::is_always_lock_free;
+    }();
+
+    // A member stored such that racing relaxed loads and stores are well defined: as one atomic if that is lock free,
+    // otherwise as consecutive atomic words, which may tear and are checked by the sequence of the SeqLocked.
+    template <typename M>
+    class SeqLockCell
+    {
+      public:
+        void Store(M const& value) noexcept
+        {
+            if constexpr (SeqLockAtomic<M>)
+                _value.store(value, std::memory_order_relaxed);
+            else
+            {
+                auto bits = std::array<std::uint64_t, Words> {};
+                std::memcpy(bits.data(), &value, sizeof(M));
+                for (size_t i = 0; i < Words; ++i)
+                    _value[i].store(bits[i], std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] M Load(std::memory_order order = std::memory_order_relaxed) const noexcept
+        {
+            if constexpr (SeqLockAtomic<M>)
+                return _value.load(order);
+            else
+            {
+                auto bits = std::array<std::uint64_t, Words> {};
+                for (size_t i = 0; i < Words; ++i)
+                    bits[i] = _value[i].load(order);
+                M value;
+                std::memcpy(&value, bits.data(), sizeof(M));
+                return value;
+            }
+        }
+
+      private:
+        static constexpr size_t Words = (sizeof(M) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::conditional_t<SeqLockAtomic<M>, std::atomic<M>, std::array<std::atomic<std::uint64_t>, Words>> _value {};
+    };
+
+    template <typename T, typename Indices = std::make_index_sequence<CountMembers<T>>>
+    struct SeqLockCells;
+
+    template <typename T, size_t... I>
+    struct SeqLockCells<T, std::index_sequence<I...>>
+    {
+        using type = std::tuple<SeqLockCell<std::remove_cvref_t<MemberTypeOf<I, T>>>...>;
+    };
+} // namespace detail
+
+/// A trivially copyable aggregate shared between one writer and many readers, who get consistent snapshots.
+///
+/// Each member is stored as a relaxed atomic, so that readers may race with the writer without undefined behavior,
+/// and a sequence counter tells readers whether a store happened while they were reading, in which case they retry.
+/// Readers never block the writer and never write to shared memory themselves, which makes the seqlock a good fit
+/// for frequently updated data read by many threads, such as the latest quote of an instrument:
+///
+///     auto quote = SeqLocked<Quote> {};
+///     quote.store(Quote { .bid = 99.5, .ask = 100.5 }); // publisher
+///     auto const snapshot = quote.load();               // any reader
+///     auto const bid = quote.load<&Quote::bid>();       // a single member
+///
+/// Only one thread may store at a time.
+template <typename T>
+    requires(std::is_trivially_copyable_v<T> && std::is_aggregate_v<T>)
+class SeqLocked
+{
+  public:
+    SeqLocked() = default;
+
+    explicit SeqLocked(T const& value) noexcept
+    {
+        StoreMembers(value);
+    }
+
+    SeqLocked(SeqLocked const&) = delete;
+    SeqLocked& operator=(SeqLocked const&) = delete;
+
+    /// Replaces the value. Must not be called concurrently with another store.
+    void store(T const& value) noexcept
+    {
+        auto const sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        StoreMembers(value);
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// Reads a consistent snapshot of the value, retrying while a store is in progress.
+    [[nodiscard]] T load() const noexcept
+    {
+        auto result = T {};
+        while (true)
+        {
+            auto const before = _sequence.load(std::memory_order_acquire);
+            if (before % 2 != 0)
+                continue;
+            EnumerateMembers(result, [&]<size_t I>(auto& member) { member = std::get<I>(_cells).Load(); });
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_sequence.load(std::memory_order_relaxed) == before)
+                return result;
+        }
+    }
+
+    /// Reads a single member, e.g. load<&Quote::bid>(), without copying the others.
+    ///
+    /// A member stored as one lock free atomic is read without consulting the sequence at all.
+    template <auto P>
+    [[nodiscard]] auto load() const noexcept
+    {
+        constexpr auto I = MemberIndexOf<P>;
+        using Member = std::remove_cvref_t<MemberTypeOf<I, T>>;
+        auto const& cell = std::get<I>(_cells);
+        if constexpr (detail::SeqLockAtomic<Member>)
+            return cell.Load(std::memory_order_acquire);
+        else
+            while (true)
+            {
+                auto const before = _sequence.load(std::memory_order_acquire);
+                if (before % 2 != 0)
+                    continue;
+                auto const value = cell.Load();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == before)
+                    return value;
+            }
+    }
+
+  private:
+    void StoreMembers(T const& value) noexcept
+    {
+        CallOnMembersWithoutName(value, [&]<size_t I, typename M>(M const& member) {
+            std::get<I>(_cells).Store(member);
+        });
+    }
+
+    // Odd while a store is in progress. Readers touch the sequence and the members, so both share the cache lines
+    // of the object, which in turn does not share any with its neighbors.
+    alignas(64) std::atomic<std::uint64_t> _sequence { 0 };
+    typename detail::SeqLockCells<T>::type _cells {};
+};
+
+} // namespace Reflection
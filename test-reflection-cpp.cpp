@@ -1,11 +1,127 @@
 // SPDX-License-Identifier: Apache-2.0
+#include <reflection-cpp/algorithm.hpp>
+#include <reflection-cpp/allocation-counters.hpp>
+#include <reflection-cpp/binary-chunks.hpp>
+#include <reflection-cpp/binary.hpp>
+#include <reflection-cpp/deep-size.hpp>
+#include <reflection-cpp/deferred.hpp>
+#include <reflection-cpp/columnar.hpp>
+#include <reflection-cpp/delta.hpp>
+#include <reflection-cpp/gather-writer.hpp>
+#include <reflection-cpp/generate.hpp>
+#include <reflection-cpp/indexed-vector.hpp>
+#include <reflection-cpp/msgpack.hpp>
 #include <reflection-cpp/reflection.hpp>
+#include <reflection-cpp/seq-locked.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Counting allocator: the global allocations of every thread are counted, such that tests can check that an operation
+// does not allocate at all, not only through the allocators it is given.
+
+namespace
+{
+
+thread_local size_t allocationCount = 0;
+
+void* CountedAllocate(size_t size)
+{
+    ++allocationCount;
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return CountedAllocate(size);
+}
+
+// Replaced as well, as their memory is released by the replaced operator delete, e.g. by std::stable_sort.
+void* operator new(size_t size, std::nothrow_t const& /*tag*/) noexcept
+{
+    ++allocationCount;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, std::nothrow_t const& /*tag*/) noexcept
+{
+    ++allocationCount;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::nothrow_t const& /*tag*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const& /*tag*/) noexcept
+{
+    std::free(p);
+}
 
 struct Person
 {
@@ -35,11 +151,46 @@ struct SingleValueRecord
     int value;
 };
 
+struct EmptyTag
+{
+};
+
+struct OtherEmptyTag
+{
+};
+
+struct WithEmptyMembers
+{
+    [[no_unique_address]] EmptyTag tag;
+    [[no_unique_address]] OtherEmptyTag other;
+    int value;
+};
+
 TEST_CASE("MemberIndex", "[reflection]")
 {
     static_assert(Reflection::MemberIndexOf<&Person::name> == 0);
     static_assert(Reflection::MemberIndexOf<&Person::email> == 1);
     static_assert(Reflection::MemberIndexOf<&Person::age> == 2);
+
+    // Members sharing their address are told apart by their type.
+    static_assert(Reflection::MemberIndexOf<&WithEmptyMembers::tag> == 0);
+    static_assert(Reflection::MemberIndexOf<&WithEmptyMembers::other> == 1);
+    static_assert(Reflection::MemberIndexOf<&WithEmptyMembers::value> == 2);
+
+    static_assert(Reflection::MemberIndexOf<&TestStruct::e> == Reflection::detail::MemberIndexOfByName<&TestStruct::e>);
+}
+
+TEST_CASE("MemberNames", "[reflection]")
+{
+    constexpr auto names = Reflection::MemberNames<Person>;
+    static_assert(names.size() == 3);
+    static_assert(names[0] == "name" && names[1] == "email" && names[2] == "age");
+    static_assert(Reflection::MemberNameOf<1, Person const> == "email");
+
+    // All names of a type are views into one contiguous blob.
+    CHECK(names[1].data() == names[0].data() + names[0].size());
+    CHECK(names[2].data() == names[1].data() + names[1].size());
+    CHECK(Reflection::MemberNames<Person const>[0].data() == names[0].data());
 }
 
 TEST_CASE("TypeNameOf", "[reflection]")
@@ -295,3 +446,1532 @@ TEST_CASE("TemplateFor over sequence", "[refleciton]")
     Reflection::template_for<std::integer_sequence<size_t, 3, 2, 1>>([&]<size_t I>(){result += std::to_string(I);});
     CHECK(result == "321");
 }
+
+TEST_CASE("InspectTo", "[reflection]")
+{
+    auto p = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    auto buffer = std::string { "person: " };
+    Reflection::InspectTo(buffer, p);
+    CHECK(buffer == R"(person: name="John Doe" email="john@doe.com" age=42)");
+}
+
+TEST_CASE("InspectTo.no_allocations", "[reflection]")
+{
+    using CountingString = std::basic_string<char, std::char_traits<char>, Reflection::CountingAllocator<char>>;
+
+    auto const p = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    auto const ts = TestStruct { .a = 1, .b = 2.0f, .c = 3.0, .d = "hello", .e = p };
+    auto const r = Record { .id = 1, .name = "Jane Doe", .age = 43 };
+    auto const v = std::vector<Person> { p, p, p };
+
+    auto buffer = CountingString {};
+    buffer.reserve(1024);
+
+    // Neither the buffer may grow, nor may InspectTo allocate anything else, such as formatting temporaries.
+    auto const checkNoAllocations = [&](auto const& object) {
+        buffer.clear();
+        auto const before = Reflection::CurrentThreadAllocations();
+        auto const globalBefore = allocationCount;
+        Reflection::InspectTo(buffer, object);
+        auto const globalAllocations = allocationCount - globalBefore;
+        CHECK(Reflection::CurrentThreadAllocations() == before);
+        CHECK(globalAllocations == 0);
+        CHECK(buffer == Reflection::Inspect(object).c_str());
+    };
+    checkNoAllocations(SingleValueRecord { 42 });
+    checkNoAllocations(p);
+    checkNoAllocations(ts);
+    checkNoAllocations(r);
+    checkNoAllocations(v);
+}
+
+TEST_CASE("InspectTo.growth", "[reflection]")
+{
+    using CountingString = std::basic_string<char, std::char_traits<char>, Reflection::CountingAllocator<char>>;
+
+    // Appending many objects to one buffer grows it geometrically, not by the size of every object.
+    auto const p = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    auto buffer = CountingString {};
+    auto const before = Reflection::CurrentThreadAllocations();
+    for (size_t i = 0; i < 10'000; ++i)
+        Reflection::InspectTo(buffer, p);
+    CHECK((Reflection::CurrentThreadAllocations() - before).allocations < 32);
+    CHECK(buffer.size() == 10'000 * Reflection::Inspect(p).size());
+}
+
+TEST_CASE("Inspect.counting_policy", "[reflection]")
+{
+    Reflection::AllocationCounters::Reset();
+
+    auto const p = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    auto const result = Reflection::Inspect<Reflection::CountingInspectPolicy>(p);
+    CHECK(result == R"(name="John Doe" email="john@doe.com" age=42)");
+
+    auto const entry = Reflection::AllocationCounters::Get<Person>();
+    CHECK(entry.calls == 1);
+    CHECK(entry.last.allocations > 0);
+    CHECK(entry.last.bytes > result.size());
+    CHECK(entry.total == entry.last);
+
+    std::ignore = Reflection::Inspect<Reflection::CountingInspectPolicy>(p);
+    CHECK(Reflection::AllocationCounters::Get<Person>().calls == 2);
+    CHECK(Reflection::AllocationCounters::Get<Record>().calls == 0);
+
+    auto const snapshot = Reflection::AllocationCounters::Snapshot();
+    REQUIRE(snapshot.size() == 1);
+    CHECK(snapshot[0].first == "Person");
+}
+
+struct RecordView
+{
+    int age;
+    std::string_view name;
+    int id;
+    int unrelated = 7;
+};
+
+struct Point
+{
+    int x;
+    int y;
+};
+
+struct PointF
+{
+    double y;
+    double x;
+};
+
+struct LabeledPoint
+{
+    std::string label;
+    Point position;
+};
+
+struct LabeledPointF
+{
+    PointF position;
+    std::string label;
+};
+
+struct SamePoint
+{
+    int x;
+    int y;
+};
+
+TEST_CASE("AssignByName", "[reflection]")
+{
+    auto r = Record {};
+    Reflection::AssignByName(r, RecordView { .age = 42, .name = "John Doe", .id = 1 });
+    CHECK(r.id == 1);
+    CHECK(r.name == "John Doe");
+    CHECK(r.age == 42);
+
+    auto view = RecordView {};
+    Reflection::AssignByName(view, r);
+    CHECK(view.age == 42);
+    CHECK(view.name == "John Doe");
+    CHECK(view.id == 1);
+    CHECK(view.unrelated == 7);
+}
+
+TEST_CASE("AssignByName.move", "[reflection]")
+{
+    auto source = Record { .id = 1, .name = std::string(100, 'x'), .age = 42 };
+    auto target = Record {};
+    Reflection::AssignByName(target, std::move(source));
+    CHECK(target.name == std::string(100, 'x'));
+    CHECK(source.name.empty()); // NOLINT(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+}
+
+TEST_CASE("AssignByName.nested_with_conversion", "[reflection]")
+{
+    auto const source = LabeledPointF { .position = { .y = 2.5, .x = 1.5 }, .label = "a" };
+    auto target = LabeledPoint {};
+    Reflection::AssignByName<Reflection::MemberConversion::Arithmetic>(target, source);
+    CHECK(target.label == "a");
+    CHECK(target.position.x == 1);
+    CHECK(target.position.y == 2);
+}
+
+TEST_CASE("AssignByName.identical_layout", "[reflection]")
+{
+    static_assert(Reflection::HasIdenticalLayout<SamePoint, Point>);
+    static_assert(!Reflection::HasIdenticalLayout<PointF, Point>);
+    static_assert(!Reflection::HasIdenticalLayout<RecordView, Record>);
+
+    auto target = SamePoint {};
+    Reflection::AssignByName(target, Point { .x = 1, .y = 2 });
+    CHECK(target.x == 1);
+    CHECK(target.y == 2);
+
+    constexpr auto folded = [] {
+        auto p = SamePoint {};
+        Reflection::AssignByName(p, Point { .x = 3, .y = 4 });
+        return p.x * 10 + p.y;
+    }();
+    static_assert(folded == 34);
+}
+
+struct BinaryRecord
+{
+    int id {};
+    std::string name;
+    double score {};
+    Color color {};
+    std::vector<std::string> tags;
+    Record nested;
+};
+
+TEST_CASE("Binary.fixed_layout", "[reflection]")
+{
+    auto const original = BinaryRecord { .id = 7,
+                                         .name = "John Doe",
+                                         .score = 1.5,
+                                         .color = Color::Blue,
+                                         .tags = { "a", "bc" },
+                                         .nested = { .id = 1, .name = "Jane Doe", .age = 43 } };
+    std::vector<std::byte> buffer;
+    Reflection::SerializeBinary(original, buffer);
+    CHECK(buffer.size() == 4 + (4 + 8) + 8 + 1 + (4 + 4 + 1 + 4 + 2) + (4 + 4 + 8 + 4));
+
+    auto decoded = BinaryRecord {};
+    CHECK(Reflection::DeserializeBinary(buffer, decoded));
+    CHECK(Reflection::Inspect(decoded.nested) == Reflection::Inspect(original.nested));
+    CHECK(decoded.id == 7);
+    CHECK(decoded.name == "John Doe");
+    CHECK(decoded.score == 1.5);
+    CHECK(decoded.color == Color::Blue);
+    CHECK(decoded.tags == original.tags);
+
+    auto truncated = BinaryRecord {};
+    CHECK_FALSE(Reflection::DeserializeBinary(std::span(buffer).first(buffer.size() - 1), truncated));
+}
+
+namespace v1
+{
+struct Message
+{
+    int id {};
+    std::string text;
+    std::vector<Record> records;
+};
+} // namespace v1
+
+namespace v2
+{
+struct Message
+{
+    std::vector<Record> records;
+    std::uint64_t timestamp {};
+    int id {};
+    std::string author = "nobody";
+};
+} // namespace v2
+
+TEST_CASE("Binary.tagged_schema_evolution", "[reflection]")
+{
+    static_assert(Reflection::MemberTagOf<0, v1::Message> == Reflection::MemberTagOf<2, v2::Message>);
+
+    auto const old = v1::Message { .id = 42,
+                                   .text = "hello",
+                                   .records = { { .id = 1, .name = "John Doe", .age = 42 } } };
+    std::vector<std::byte> buffer;
+    Reflection::SerializeTagged(old, buffer);
+
+    auto same = v1::Message {};
+    CHECK(Reflection::DeserializeTagged(buffer, same));
+    CHECK(same.id == 42);
+    CHECK(same.text == "hello");
+    REQUIRE(same.records.size() == 1);
+    CHECK(same.records[0].name == "John Doe");
+
+    // Newer reader: unknown "text" is skipped, missing members keep their defaults.
+    auto newer = v2::Message {};
+    CHECK(Reflection::DeserializeTagged(buffer, newer));
+    CHECK(newer.id == 42);
+    CHECK(newer.timestamp == 0);
+    CHECK(newer.author == "nobody");
+    REQUIRE(newer.records.size() == 1);
+    CHECK(newer.records[0].age == 42);
+
+    // Older reader of a newer message.
+    newer.timestamp = 1234;
+    newer.author = "Jane Doe";
+    buffer.clear();
+    Reflection::SerializeTagged(newer, buffer);
+    auto older = v1::Message {};
+    CHECK(Reflection::DeserializeTagged(buffer, older));
+    CHECK(older.id == 42);
+    CHECK(older.text.empty());
+    REQUIRE(older.records.size() == 1);
+    CHECK(older.records[0].id == 1);
+
+    CHECK_FALSE(Reflection::DeserializeTagged(std::span(buffer).first(buffer.size() - 2), older));
+}
+
+struct PlayerState
+{
+    std::uint64_t id {};
+    Point position;
+    std::string name;
+    float health {};
+    std::vector<int> inventory;
+    LabeledPoint target;
+};
+
+TEST_CASE("Delta.roundtrip", "[reflection]")
+{
+    auto const before = PlayerState { .id = 7,
+                                      .position = { .x = 1, .y = 2 },
+                                      .name = "player",
+                                      .health = 100.0f,
+                                      .inventory = { 1, 2, 3 },
+                                      .target = { .label = "base", .position = { .x = 10, .y = 20 } } };
+    auto after = before;
+    after.position.y = 3;
+    after.health = 50.0f;
+    after.target.position.x = 11;
+
+    std::vector<std::byte> delta;
+    CHECK(Reflection::EncodeDelta(before, after, delta));
+
+    std::vector<std::byte> full;
+    Reflection::SerializeBinary(after, full);
+    // bitmaps of PlayerState, position, target and target.position, plus y, health and x.
+    CHECK(delta.size() == 4 + 3 * 4);
+    CHECK(delta.size() < full.size() / 3);
+
+    auto applied = before;
+    REQUIRE(Reflection::ApplyDelta(applied, delta));
+    CHECK(applied.position.y == 3);
+    CHECK(applied.health == 50.0f);
+    CHECK(applied.target.position.x == 11);
+    CHECK(applied.target.position.y == 20);
+    CHECK(applied.name == "player");
+    CHECK(applied.inventory == after.inventory);
+
+    CHECK_FALSE(Reflection::ApplyDelta(applied, std::span(delta).first(delta.size() - 1)));
+}
+
+TEST_CASE("Delta.unchanged", "[reflection]")
+{
+    auto const state = PlayerState {
+        .id = 1, .position = {}, .name = "player", .health = 1.0f, .inventory = { 1 }, .target = {}
+    };
+    std::vector<std::byte> delta;
+    CHECK_FALSE(Reflection::EncodeDelta(state, state, delta));
+    CHECK(delta.size() == 1);
+
+    auto changed = state;
+    changed.inventory.push_back(2);
+    changed.name = "renamed";
+    delta.clear();
+    CHECK(Reflection::EncodeDelta(state, changed, delta));
+
+    auto applied = state;
+    REQUIRE(Reflection::ApplyDelta(applied, delta));
+    CHECK(applied.name == "renamed");
+    CHECK(applied.inventory == std::vector { 1, 2 });
+}
+
+struct Tick
+{
+    std::int64_t price;
+    std::int64_t volume;
+    std::int32_t bid;
+    std::int32_t ask;
+    std::uint16_t venue;
+    std::uint8_t side;
+    Color color;
+    std::int32_t sequence;
+};
+
+TEST_CASE("Compare.bytewise", "[reflection]")
+{
+    auto const t1 = Tick {
+        .price = 100, .volume = 5, .bid = 99, .ask = 101, .venue = 1, .side = 0, .color = Color::Red, .sequence = 1
+    };
+    auto t2 = t1;
+
+    std::string diff;
+    auto differenceCallback = [&](std::string_view name, auto const& lhs, auto const& rhs) {
+        diff += std::format("{}: {} != {}\n", name, +lhs, +rhs);
+    };
+
+    Reflection::CollectDifferences(t1, t2, differenceCallback);
+    CHECK(diff.empty());
+
+    t2.volume = 5 + (1ll << 40); // differs in a high byte only
+    t2.side = 1;
+    t2.sequence = 2;
+    Reflection::CollectDifferences(t1, t2, differenceCallback);
+    CHECK(diff == "volume: 5 != 1099511627781\nside: 0 != 1\nsequence: 1 != 2\n");
+
+    auto indices = std::vector<size_t> {};
+    Reflection::CollectDifferences(t1, t2, [&](size_t index, auto const&, auto const&) { indices.push_back(index); });
+    CHECK(indices == std::vector<size_t> { 1, 5, 7 });
+}
+
+// 46 bytes, such that the comparison runs through the vectorized, the 8 byte and the single byte loops.
+struct OddSizedRecord
+{
+    std::int16_t a0;
+    std::int16_t a1;
+    std::int16_t a2;
+    std::int16_t a3;
+    std::int16_t a4;
+    std::int16_t a5;
+    std::int16_t a6;
+    std::int16_t a7;
+    std::int16_t a8;
+    std::int16_t a9;
+    std::int16_t a10;
+    std::int16_t a11;
+    std::int16_t a12;
+    std::int16_t a13;
+    std::int16_t a14;
+    std::int16_t a15;
+    std::int16_t a16;
+    std::int16_t a17;
+    std::int16_t a18;
+    std::int16_t a19;
+    std::int16_t a20;
+    std::int16_t a21;
+    std::int16_t a22;
+};
+
+TEST_CASE("Compare.bytewise_every_byte", "[reflection]")
+{
+    static_assert(sizeof(OddSizedRecord) == 46);
+
+    auto const original = OddSizedRecord {};
+    for (size_t byte = 0; byte < sizeof(OddSizedRecord); ++byte)
+    {
+        auto changed = original;
+        reinterpret_cast<unsigned char*>(&changed)[byte] = 0xFF;
+
+        auto indices = std::vector<size_t> {};
+        Reflection::CollectDifferences(
+            original, changed, [&](size_t index, auto const&, auto const&) { indices.push_back(index); });
+        CHECK(indices == std::vector<size_t> { byte / 2 });
+    }
+}
+
+struct Trade
+{
+    std::int64_t timestamp;
+    double price;
+    std::string symbol;
+    std::int32_t quantity;
+    Color side;
+};
+
+TEST_CASE("Columnar.roundtrip", "[reflection]")
+{
+    auto const path = std::filesystem::temp_directory_path() / "reflection-cpp-test-columnar.bin";
+
+    // Small row groups, such that the rows span several of them and the last one is partial.
+    auto writer = Reflection::ColumnWriter<Trade> {};
+    REQUIRE(writer.Open(path, 16));
+    auto trades = std::vector<Trade> {};
+    for (size_t i = 0; i < 100; ++i)
+        trades.push_back(Trade { .timestamp = 1000 + static_cast<std::int64_t>(i),
+                                 .price = static_cast<double>(i) * 0.5,
+                                 .symbol = i % 2 ? "ACME" : std::string(i, 'x'),
+                                 .quantity = static_cast<std::int32_t>(i * 10),
+                                 .side = static_cast<Color>(i % 3) });
+    writer.Append(trades);
+    writer.Append(Trade { .timestamp = 0, .price = 1.0, .symbol = "last", .quantity = -1, .side = Color::Blue });
+    CHECK(writer.size() == 101);
+    REQUIRE(writer.Close());
+
+    auto reader = Reflection::ColumnReader<Trade> {};
+    REQUIRE(reader.Open(path));
+    REQUIRE(reader.size() == 101);
+    REQUIRE(reader.rowGroups() == 7);
+
+    auto const timestamps = reader.Column<0>(0);
+    static_assert(std::same_as<decltype(timestamps), std::span<std::int64_t const> const>);
+    REQUIRE(timestamps.size() == 16);
+    CHECK(timestamps[0] == 1000);
+    CHECK(reader.Column<0>(6).size() == 5);
+    CHECK(reader.Column<0>(6)[3] == 1099);
+    CHECK(reinterpret_cast<std::uintptr_t>(timestamps.data()) % alignof(std::int64_t) == 0);
+
+    auto const prices = reader.Column<&Trade::price>(0);
+    CHECK(prices[10] == 5.0);
+
+    auto const symbols = reader.Column<&Trade::symbol>(0);
+    REQUIRE(symbols.size() == 16);
+    CHECK(symbols[0].empty());
+    CHECK(symbols[1] == "ACME");
+    CHECK(symbols[4] == "xxxx");
+    CHECK(reader.Column<&Trade::symbol>(1)[2] == std::string(18, 'x'));
+    CHECK(reader.Column<&Trade::symbol>(6)[4] == "last");
+
+    auto row = Trade {};
+    reader.ReadRow(42, row);
+    CHECK(row.timestamp == trades[42].timestamp);
+    CHECK(row.symbol == trades[42].symbol);
+    CHECK(row.quantity == 420);
+    CHECK(row.side == Color::Red);
+    reader.ReadRow(100, row);
+    CHECK(row.symbol == "last");
+
+    // Files of a different type are rejected.
+    CHECK_FALSE(Reflection::ColumnReader<Record> {}.Open(path));
+
+    // Truncated files are rejected.
+    reader.Close();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    CHECK_FALSE(reader.Open(path));
+
+    std::filesystem::remove(path);
+}
+
+struct Measurement
+{
+    std::string sensor;
+    std::int32_t count;
+    double value;
+    bool valid;
+    std::uint8_t level;
+};
+
+TEST_CASE("ReduceMembers", "[reflection]")
+{
+    auto measurements = std::vector<Measurement> {};
+    for (int i = 0; i < 1000; ++i)
+        measurements.push_back(Measurement { .sensor = "s",
+                                             .count = i - 500,
+                                             .value = i * 0.5,
+                                             .valid = i % 2 == 0,
+                                             .level = static_cast<std::uint8_t>(200 + i % 50) });
+
+    auto const sum = Reflection::ReduceMembers(measurements, Reflection::Reduce::Sum {});
+    static_assert(std::same_as<std::remove_cvref_t<decltype(std::get<0>(sum))>, Reflection::NotReduced>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype(std::get<1>(sum))>, std::int64_t>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype(std::get<3>(sum))>, Reflection::NotReduced>);
+    CHECK(std::get<1>(sum) == -500);
+    CHECK(std::get<2>(sum) == 999 * 1000 / 4.0);
+    CHECK(std::get<4>(sum) == 1000 * 200 + 20 * (49 * 50 / 2));
+
+    auto const min = Reflection::ReduceMembers(measurements, Reflection::Reduce::Min {});
+    CHECK(std::get<1>(min) == -500);
+    CHECK(std::get<4>(min) == 200);
+
+    auto const max = Reflection::ReduceMembers(measurements, Reflection::Reduce::Max {});
+    CHECK(std::get<1>(max) == 499);
+    CHECK(std::get<2>(max) == 499.5);
+
+    auto const mean = Reflection::ReduceMembers(measurements, Reflection::Reduce::Mean {});
+    CHECK(std::get<1>(mean) == -0.5);
+    CHECK(std::get<2>(mean) == 249.75);
+
+    auto const parallel =
+        Reflection::ReduceMembers(measurements, Reflection::Reduce::Sum {}, Reflection::Parallelism { .threads = 3 });
+    CHECK(parallel == sum);
+
+    auto const empty = Reflection::ReduceMembers(std::span<Measurement const> {}, Reflection::Reduce::Mean {});
+    CHECK(std::isnan(std::get<2>(empty)));
+}
+
+TEST_CASE("TransformMembers", "[reflection]")
+{
+    auto measurements = std::vector<Measurement>(5000);
+    for (size_t i = 0; i < measurements.size(); ++i)
+        measurements[i] = Measurement { .sensor = "s",
+                                        .count = static_cast<std::int32_t>(i),
+                                        .value = static_cast<double>(i),
+                                        .valid = true,
+                                        .level = 1 };
+
+    Reflection::TransformMembers(measurements, std::index_sequence<1, 2> {}, [](auto& value) { value *= 2; });
+    CHECK(measurements[10].count == 20);
+    CHECK(measurements[10].value == 20.0);
+    CHECK(measurements[10].level == 1);
+
+    auto pool = Reflection::ThreadPool { 3 };
+    Reflection::TransformMembers(
+        measurements,
+        std::index_sequence<2, 4> {},
+        [&]<size_t I>(auto& value) {
+            if constexpr (I == 2)
+                value = -value;
+            else
+                value += 1;
+        },
+        Reflection::Parallelism { .threads = 4, .pool = &pool });
+    auto const transformed = std::ranges::count_if(measurements, [&](Measurement const& m) {
+        return m.value == -2.0 * m.count / 2 && m.level == 2;
+    });
+    CHECK(transformed == 5000);
+    CHECK(measurements[4999].count == 9998);
+}
+
+// Reduction whose accumulators fail on every value.
+struct ThrowingReduce
+{
+    template <typename T>
+    struct Accumulator
+    {
+        void Update(T /*value*/)
+        {
+            throw std::runtime_error("reduce failed");
+        }
+
+        void Merge(Accumulator const& /*other*/) {}
+
+        [[nodiscard]] int Result() const
+        {
+            return 0;
+        }
+    };
+};
+
+TEST_CASE("ForEachChunk.exception", "[reflection]")
+{
+    auto measurements = std::vector<Measurement>(5000);
+    for (size_t i = 0; i < measurements.size(); ++i)
+        measurements[i].count = static_cast<std::int32_t>(i);
+
+    // Four chunks of 1250 objects, the first on the calling thread and the others on the pool. The last object of
+    // every chunk throws; all chunks must still finish before the exception leaves TransformMembers, and the
+    // exceptions on the pool must not terminate.
+    auto pool = Reflection::ThreadPool { 3 };
+    auto const parallelism = Reflection::Parallelism { .threads = 4, .pool = &pool };
+    auto const transform = [&](bool fail) {
+        Reflection::TransformMembers(
+            measurements,
+            std::index_sequence<1> {},
+            [&](std::int32_t& count) {
+                if (fail && count % 1250 == 1249)
+                    throw std::runtime_error("transform failed");
+                count = -count;
+            },
+            parallelism);
+    };
+    CHECK_THROWS_AS(transform(true), std::runtime_error);
+    CHECK(measurements[1].count == -1);
+    CHECK(measurements[1248].count == -1248);
+    CHECK(measurements[1249].count == 1249);
+    CHECK(measurements[4998].count == -4998);
+    CHECK(measurements[4999].count == 4999);
+
+    CHECK_THROWS_AS(std::ignore = Reflection::ReduceMembers(measurements, ThrowingReduce {}, parallelism),
+                    std::runtime_error);
+
+    // The pool is still usable afterwards.
+    CHECK_NOTHROW(transform(false));
+    CHECK(measurements[1].count == 1);
+    CHECK(measurements[4999].count == -4999);
+}
+
+struct Order
+{
+    std::int16_t venue;
+    float price;
+    std::string trader;
+    std::int64_t sequence;
+};
+
+TEST_CASE("SortBy", "[reflection]")
+{
+    auto orders = std::vector<Order> {};
+    std::uint32_t seed = 42;
+    auto const next = [&] {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    for (std::int64_t i = 0; i < 5000; ++i)
+        orders.push_back(Order { .venue = static_cast<std::int16_t>(static_cast<int>(next() % 7) - 3),
+                                 .price = static_cast<float>(static_cast<int>(next() % 200) - 100) / 8.0f,
+                                 .trader = std::string(1, static_cast<char>('a' + next() % 26)),
+                                 .sequence = i });
+
+    auto const checkSorted = [&](auto less, auto sorted) {
+        auto expected = orders;
+        std::ranges::stable_sort(expected, less);
+        sorted(orders);
+        CHECK(std::ranges::equal(orders, expected, [](Order const& a, Order const& b) {
+            return a.sequence == b.sequence;
+        }));
+    };
+
+    // radix sorted
+    checkSorted(Reflection::LessBy<&Order::venue, &Order::price> {},
+                [](auto& v) { Reflection::SortBy<&Order::venue, &Order::price>(v); });
+    checkSorted(Reflection::LessBy<&Order::price> {}, [](auto& v) { Reflection::SortBy<&Order::price>(v); });
+    checkSorted(Reflection::LessBy<&Order::sequence> {}, [](auto& v) { Reflection::SortBy<&Order::sequence>(v); });
+    // sorted by comparison
+    checkSorted(Reflection::LessBy<&Order::trader, &Order::venue> {},
+                [](auto& v) { Reflection::SortBy<&Order::trader, &Order::venue>(v); });
+
+    CHECK(std::ranges::is_sorted(orders, Reflection::LessBy<&Order::trader, &Order::venue> {}));
+    CHECK(orders.front().trader == "a");
+}
+
+TEST_CASE("SortBy.signedZero", "[reflection]")
+{
+    // Radix sorted above the threshold, by comparison below; both must keep -0.0 and +0.0 in their original order.
+    for (auto const count: { size_t { 100 }, size_t { 5000 } })
+    {
+        auto orders = std::vector<Order> {};
+        for (size_t i = 0; i < count; ++i)
+            orders.push_back(Order { .venue = static_cast<std::int16_t>(i % 2),
+                                     .price = i % 3 == 0 ? 1.0f : (i % 3 == 1 ? -0.0f : 0.0f),
+                                     .trader = {},
+                                     .sequence = static_cast<std::int64_t>(i) });
+
+        auto const checkSorted = [&](auto less, auto sorted) {
+            auto expected = orders;
+            std::ranges::stable_sort(expected, less);
+            sorted(orders);
+            CHECK(std::ranges::equal(orders, expected, [](Order const& a, Order const& b) {
+                return a.sequence == b.sequence && std::signbit(a.price) == std::signbit(b.price);
+            }));
+        };
+        checkSorted(Reflection::LessBy<&Order::price> {}, [](auto& v) { Reflection::SortBy<&Order::price>(v); });
+        checkSorted(Reflection::LessBy<&Order::venue, &Order::price> {},
+                    [](auto& v) { Reflection::SortBy<&Order::venue, &Order::price>(v); });
+    }
+}
+
+struct Employee
+{
+    int id;
+    std::string name;
+    std::string department;
+    double salary;
+};
+
+TEST_CASE("IndexedVector", "[reflection]")
+{
+    using Employees = Reflection::IndexedVector<Employee, &Employee::id, &Employee::department>;
+    static_assert(Employees::IsIndexed<&Employee::department>);
+    static_assert(!Employees::IsIndexed<&Employee::salary>);
+
+    auto employees = Employees {};
+    employees.Insert(Employee { .id = 1, .name = "Ada", .department = "R&D", .salary = 100 });
+    employees.Insert(Employee { .id = 2, .name = "Grace", .department = "R&D", .salary = 110 });
+    employees.Insert(Employee { .id = 3, .name = "Linus", .department = "Ops", .salary = 90 });
+    employees.Insert(Employee { .id = 4, .name = "Barbara", .department = "Sales", .salary = 80 });
+
+    CHECK(employees.size() == 4);
+    CHECK(employees[employees.Find<&Employee::id>(3)].name == "Linus");
+    CHECK(employees.Find<&Employee::id>(5) == Employees::npos);
+    CHECK(employees.Count<&Employee::department>("R&D") == 2);
+
+    employees.Update(employees.Find<&Employee::id>(2), [](Employee& e) {
+        e.department = "Ops";
+        e.salary = 120;
+    });
+    CHECK(employees.Count<&Employee::department>("R&D") == 1);
+    CHECK(employees.Count<&Employee::department>("Ops") == 2);
+
+    employees.Set<&Employee::department>(employees.Find<&Employee::id>(4), "R&D");
+    employees.Set<&Employee::salary>(employees.Find<&Employee::id>(4), 85.0);
+    CHECK(employees.Count<&Employee::department>("Sales") == 0);
+    CHECK(employees[employees.Find<&Employee::id>(4)].salary == 85.0);
+
+    // Erasing the first employee moves the last one into its place.
+    employees.Erase(employees.Find<&Employee::id>(1));
+    CHECK(employees.size() == 3);
+    CHECK(employees[0].id == 4);
+    CHECK(employees.Find<&Employee::id>(1) == Employees::npos);
+    CHECK(employees.Find<&Employee::id>(4) == 0);
+    auto names = std::vector<std::string> {};
+    for (auto const pos: employees.FindAll<&Employee::department>("Ops"))
+        names.push_back(employees[pos].name);
+    std::ranges::sort(names);
+    CHECK(names == std::vector<std::string> { "Grace", "Linus" });
+}
+
+struct Reading
+{
+    std::int64_t sensor;
+    std::uint8_t channel;
+    double value;
+    bool valid;
+    Point position;
+    Reflection::FixedString<8> unit;
+};
+
+TEST_CASE("Inspect.fixed_capacity", "[reflection]")
+{
+    auto const reading = Reading { .sensor = std::numeric_limits<std::int64_t>::min(),
+                                   .channel = 255,
+                                   .value = -std::numeric_limits<double>::denorm_min(),
+                                   .valid = false,
+                                   .position = { .x = std::numeric_limits<int>::min(), .y = -1 },
+                                   .unit = Reflection::FixedString<8> { "Celsius" } };
+    auto const text = Reflection::Inspect<Reflection::FixedCapacity<>>(reading);
+    static_assert(std::is_same_v<decltype(text), Reflection::FixedString<137> const>);
+    CHECK(text.sv() == Reflection::Inspect(reading));
+
+    // Unbounded strings have no upper bound unless they are cut.
+    auto const p = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    static_assert(std::is_same_v<decltype(Reflection::Inspect<Reflection::FixedCapacity<>>(p)), std::string>);
+    CHECK(Reflection::Inspect<Reflection::FixedCapacity<>>(p) == Reflection::Inspect(p));
+    CHECK(Reflection::Inspect<Reflection::FixedCapacity<4>>(p) == R"(name="John" email="john" age=42)");
+}
+
+TEST_CASE("DeferredLog", "[reflection]")
+{
+    auto lines = std::vector<std::string> {};
+    auto const point = Point { .x = 1, .y = 2 };
+    auto const person = Person { .name = "John Doe", .email = "john@doe.com", .age = 42 };
+    auto record = Record { .id = 1, .name = "Jane Doe", .age = 43 };
+    {
+        auto log = Reflection::DeferredLog<64> { 4, [&](std::string_view line) { lines.emplace_back(line); } };
+        CHECK(log.Push(Reflection::Deferred(point)));
+        CHECK(log.Push(Reflection::Deferred(record)));
+        CHECK(log.Push(Reflection::Deferred(std::cref(person))));
+        // The copies are formatted as they were when pushed.
+        record.name = "changed";
+        log.Flush();
+        CHECK(lines.size() == 3);
+
+        record.name = std::string(100, 'x');
+        CHECK(!log.Push(Reflection::Deferred(record)));
+        CHECK(log.Dropped() == 1);
+        CHECK(log.Push(Reflection::Deferred(point)));
+    }
+    // Destroying the log formats the remaining records.
+    REQUIRE(lines.size() == 4);
+    CHECK(lines[0] == Reflection::Inspect(point));
+    CHECK(lines[1] == R"(id=1 name="Jane Doe" age=43)");
+    CHECK(lines[2] == Reflection::Inspect(person));
+    CHECK(lines[3] == Reflection::Inspect(point));
+}
+
+struct DeferredView
+{
+    int id;
+    std::string_view name;
+};
+
+struct DeferredSpan
+{
+    std::span<int const> values;
+};
+
+struct DeferredPointer
+{
+    char const* text;
+};
+
+struct DeferredNested
+{
+    Point point;
+    std::array<DeferredPointer, 2> pointers;
+};
+
+TEST_CASE("DeferredLog.capture", "[reflection]")
+{
+    using Reflection::DeferredCapture;
+    using Reflection::detail::DeferredSelfContained;
+
+    // Trivially copyable objects referring to memory elsewhere must not be copied bytewise.
+    static_assert(DeferredSelfContained<Point>);
+    static_assert(DeferredSelfContained<std::array<Point, 2>>);
+    static_assert(DeferredSelfContained<std::optional<double>>);
+    static_assert(!DeferredSelfContained<DeferredView>);
+    static_assert(!DeferredSelfContained<DeferredSpan>);
+    static_assert(!DeferredSelfContained<DeferredPointer>);
+    static_assert(!DeferredSelfContained<DeferredNested>);
+    static_assert(!Reflection::detail::DeferredEncodable<DeferredView>);
+
+    auto const point = Point { .x = 1, .y = 2 };
+    auto const record = Record { .id = 1, .name = "Jane Doe", .age = 43 };
+    using PointCapture = decltype(Reflection::Deferred(point));
+    using RecordCapture = decltype(Reflection::Deferred(record));
+    static_assert(std::is_same_v<PointCapture, Reflection::DeferredObject<Point, DeferredCapture::Bytes>>);
+    static_assert(std::is_same_v<RecordCapture, Reflection::DeferredObject<Record, DeferredCapture::Encoded>>);
+
+    // Records that fail to decode are reported rather than formatted as empty lines.
+    auto encoded = std::vector<std::byte> {};
+    Reflection::SerializeBinary(record, encoded);
+    auto line = std::string {};
+    Reflection::detail::FormatEncoded<Record>(line, encoded.data(), encoded.size() - 1);
+    CHECK(line.starts_with("<undecodable "));
+    CHECK(line.find("Record") != std::string::npos);
+}
+
+enum class Severity
+{
+    Low = 1,
+    High = 3,
+};
+
+struct Snapshot
+{
+    std::vector<int> samples;
+    std::map<std::string, int> counters;
+    std::optional<double> average;
+    std::optional<double> median;
+    std::variant<int, std::string> state;
+    std::pair<int, std::string> origin;
+    std::array<Point, 2> corners;
+    Severity severity;
+};
+
+TEST_CASE("Inspect.containers", "[reflection]")
+{
+    auto const snapshot = Snapshot { .samples = { 1, 2, 3 },
+                                     .counters = { { "a", 1 }, { "b", 2 } },
+                                     .average = 2.5,
+                                     .median = std::nullopt,
+                                     .state = std::string { "running" },
+                                     .origin = { 7, "seven" },
+                                     .corners = { Point { .x = 0, .y = 0 }, Point { .x = 4, .y = 3 } },
+                                     .severity = Severity::High };
+    CHECK(Reflection::Inspect(snapshot)
+          == R"(samples=[1, 2, 3] counters={"a": 1, "b": 2} average=2.5 median=null state="running" )"
+             R"(origin=(7, "seven") corners=[{x=0 y=0}, {x=4 y=3}] severity=3)");
+
+    // Values other than records are printed the same way as members.
+    CHECK(Reflection::Inspect(std::map<int, std::vector<int>> { { 1, { 2, 3 } } }) == "{1: [2, 3]}");
+
+    // The output grows once, by an estimate large enough for all of it.
+    using CountingString = std::basic_string<char, std::char_traits<char>, Reflection::CountingAllocator<char>>;
+    auto buffer = CountingString {};
+    auto const before = Reflection::CurrentThreadAllocations();
+    Reflection::InspectTo(buffer, snapshot);
+    CHECK((Reflection::CurrentThreadAllocations() - before).allocations == 1);
+    CHECK(buffer == Reflection::Inspect(snapshot).c_str());
+}
+
+struct ArenaLine
+{
+    std::pmr::string sku;
+    std::uint32_t quantity {};
+};
+
+struct ArenaOrder
+{
+    int id {};
+    std::pmr::string customer;
+    std::pmr::vector<ArenaLine> lines;
+    std::pmr::vector<std::pmr::string> notes;
+    std::string reference;
+};
+
+TEST_CASE("Binary.memory_resource", "[reflection]")
+{
+    std::vector<std::byte> buffer;
+    for (int i = 0; i < 3; ++i)
+        Reflection::SerializeBinary(
+            ArenaOrder { .id = i,
+                         .customer = "a customer name that does not fit inline",
+                         .lines = { { .sku = "a stock keeping unit beyond the inline size", .quantity = 2 } },
+                         .notes = { "a note that is long enough to be allocated" },
+                         .reference = "a reference outside of the arena" },
+            buffer);
+
+    auto storage = std::array<std::byte, 4096> {};
+    auto arena =
+        std::pmr::monotonic_buffer_resource { storage.data(), storage.size(), std::pmr::null_memory_resource() };
+    auto orders = std::pmr::vector<ArenaOrder> { &arena };
+    CHECK(Reflection::DeserializeBinaryBatch(buffer, orders));
+    REQUIRE(orders.size() == 3);
+    for (auto const& order: orders)
+    {
+        CHECK(order.customer == "a customer name that does not fit inline");
+        CHECK(order.customer.get_allocator().resource() == &arena);
+        CHECK(order.lines.get_allocator().resource() == &arena);
+        CHECK(order.lines.at(0).sku.get_allocator().resource() == &arena);
+        CHECK(order.lines.at(0).quantity == 2);
+        CHECK(order.notes.at(0).get_allocator().resource() == &arena);
+        CHECK(order.reference == "a reference outside of the arena");
+    }
+    CHECK(orders[2].id == 2);
+
+    // Objects decoded without a resource keep their allocators.
+    auto order = ArenaOrder {};
+    CHECK(Reflection::DeserializeBinary(buffer, order));
+    CHECK(order.customer.get_allocator().resource() == std::pmr::get_default_resource());
+
+    auto truncated = std::pmr::vector<ArenaOrder> { &arena };
+    CHECK_FALSE(Reflection::DeserializeBinaryBatch(std::span(buffer).first(buffer.size() - 1), truncated));
+    CHECK(truncated.size() == 2);
+
+    std::vector<std::byte> tagged;
+    Reflection::SerializeTagged(orders[1], tagged);
+    auto reader = Reflection::BinaryReader { tagged };
+    CHECK(Reflection::DeserializeTagged(reader, order, &arena));
+    CHECK(order.id == 1);
+    CHECK(order.lines.at(0).sku.get_allocator().resource() == &arena);
+}
+
+enum class Side : std::uint8_t
+{
+    Buy = 1,
+    Sell = 2,
+};
+
+struct Fill
+{
+    std::int8_t venue {};
+    double price {};
+};
+
+struct TradeOrder
+{
+    std::uint64_t id {};
+    Side side {};
+    std::string trader;
+    std::vector<Fill> fills;
+    bool active {};
+};
+
+template <>
+struct Reflection::GenerateDistribution<Side>
+{
+    static constexpr std::array values = { Side::Buy, Side::Sell };
+};
+
+template <>
+struct Reflection::GenerateDistribution<std::int8_t>
+{
+    static constexpr int min = -3;
+    static constexpr int max = 3;
+};
+
+template <>
+struct Reflection::GenerateDistribution<std::vector<Fill>>
+{
+    static constexpr size_t minSize = 1;
+    static constexpr size_t maxSize = 3;
+};
+
+TEST_CASE("Generate", "[reflection]")
+{
+    auto rng = std::mt19937_64 { 42 };
+    auto const orders = Reflection::Generate<TradeOrder>(rng, 1000);
+    REQUIRE(orders.size() == 1000);
+
+    auto const isLetter = [](char c) { return c >= 'a' && c <= 'z'; };
+    auto const isValidFill = [](Fill const& fill) {
+        return fill.venue >= -3 && fill.venue <= 3 && fill.price >= 0.0 && fill.price < 1000.0;
+    };
+    CHECK(std::ranges::all_of(orders, [&](TradeOrder const& order) {
+        return order.id <= 1'000'000 && (order.side == Side::Buy || order.side == Side::Sell)
+               && order.trader.size() >= 4 && order.trader.size() <= 16 && std::ranges::all_of(order.trader, isLetter)
+               && order.fills.size() >= 1 && order.fills.size() <= 3 && std::ranges::all_of(order.fills, isValidFill);
+    }));
+    auto const sells = std::ranges::count(orders, Side::Sell, &TradeOrder::side);
+    auto const active = std::ranges::count(orders, true, &TradeOrder::active);
+    CHECK(sells > 400);
+    CHECK(sells < 600);
+    CHECK(active > 400);
+    CHECK(active < 600);
+
+    // The same seed yields the same data, whether generated in bulk or one by one.
+    rng.seed(42);
+    auto order = TradeOrder {};
+    Reflection::GenerateInto(rng, order);
+    CHECK(Reflection::Inspect(order) == Reflection::Inspect(orders.front()));
+
+    auto preallocated = std::vector<TradeOrder>(10);
+    Reflection::Generate(rng, std::span { preallocated });
+    CHECK(Reflection::Inspect(preallocated[0]) == Reflection::Inspect(orders[1]));
+}
+
+struct CacheEntry
+{
+    std::uint32_t key {};
+    std::string label;
+    std::vector<std::string> aliases;
+    std::optional<std::string> comment;
+    std::unique_ptr<Point> location;
+};
+
+TEST_CASE("DeepSizeOf", "[reflection]")
+{
+    CHECK(Reflection::DeepSizeOf(Point {}) == sizeof(Point));
+
+    auto const shortText = std::string { "a" };
+    auto const longText = std::string(100, 'x');
+    CHECK(Reflection::HeapSizeOf(shortText) == 0);
+    CHECK(Reflection::HeapSizeOf(longText) == longText.capacity() + 1);
+
+    auto entry = CacheEntry {};
+    entry.key = 1;
+    entry.label = "short";
+    CHECK(Reflection::DeepSizeOf(entry) == sizeof(CacheEntry));
+
+    entry.label = longText;
+    entry.aliases.reserve(4);
+    entry.aliases.push_back(longText);
+    entry.comment = longText;
+    entry.location = std::make_unique<Point>();
+    auto const longHeap = longText.capacity() + 1;
+    auto const aliasesHeap = entry.aliases.capacity() * sizeof(std::string) + longHeap;
+    CHECK(Reflection::DeepSizeOf(entry) == sizeof(CacheEntry) + 2 * longHeap + aliasesHeap + sizeof(Point));
+
+    auto entries = std::vector<CacheEntry> {};
+    entries.push_back(std::move(entry));
+    entries.emplace_back().label = "short";
+    CHECK(Reflection::DeepSizeOf(std::span { entries })
+          == 2 * sizeof(CacheEntry) + Reflection::HeapSizeOf(entries[0]));
+    CHECK(Reflection::DeepSizeOf(entries)
+          == sizeof(entries) + entries.capacity() * sizeof(CacheEntry) + Reflection::HeapSizeOf(entries[0]));
+
+    auto const report = Reflection::DeepSizeReport(entries);
+    CHECK(report.objects == 2);
+    CHECK(report.members[1].name == "label");
+    CHECK(report.members[1].inlineBytes == 2 * sizeof(std::string));
+    CHECK(report.members[1].heapBytes == longHeap);
+    CHECK(report.members[2].heapBytes == aliasesHeap);
+    CHECK(report.members[4].heapBytes == sizeof(Point));
+    auto const memberBytes = sizeof(std::uint32_t) + sizeof(std::string) + sizeof(std::vector<std::string>)
+                             + sizeof(std::optional<std::string>) + sizeof(std::unique_ptr<Point>);
+    CHECK(report.paddingBytes == 2 * (sizeof(CacheEntry) - memberBytes));
+    CHECK(report.total() == Reflection::DeepSizeOf(std::span { entries }));
+    CHECK(Reflection::Inspect(report).starts_with(R"(objects=2 paddingBytes=)"));
+}
+
+TEST_CASE("DeepSizeOf.containers", "[reflection]")
+{
+    auto const longText = std::string(100, 'x');
+    auto const longHeap = longText.capacity() + 1;
+
+    // Node based containers count one node per element, at least the value and the links.
+    auto const list = std::list<int> { 1, 2, 3 };
+    auto const listNode = Reflection::HeapSizeOf(std::list<int> { 1 });
+    CHECK(listNode >= sizeof(int) + 2 * sizeof(void*));
+    CHECK(Reflection::HeapSizeOf(list) == 3 * listNode);
+    CHECK(Reflection::HeapSizeOf(std::list<int> {}) == 0);
+
+    auto const mapNode = Reflection::HeapSizeOf(std::map<int, std::string> { { 1, "a" } });
+    CHECK(mapNode >= sizeof(std::pair<int const, std::string>) + 3 * sizeof(void*));
+    auto const map = std::map<int, std::string> { { 1, "a" }, { 2, longText } };
+    CHECK(Reflection::HeapSizeOf(map) == 2 * mapNode + longHeap);
+
+    auto const hashed = std::unordered_map<int, int> { { 1, 1 }, { 2, 2 } };
+    CHECK(Reflection::HeapSizeOf(hashed)
+          >= hashed.bucket_count() * sizeof(void*) + 2 * (sizeof(std::pair<int const, int>) + sizeof(void*)));
+
+    auto const queue = std::deque<int>(1000);
+    CHECK(Reflection::HeapSizeOf(queue) >= 1000 * sizeof(int));
+
+    // A std::variant counts its held alternative.
+    auto variant = std::variant<int, std::string> { 1 };
+    CHECK(Reflection::HeapSizeOf(variant) == 0);
+    variant = longText;
+    CHECK(Reflection::HeapSizeOf(variant) == longHeap);
+    auto const variants = std::vector { variant };
+    CHECK(Reflection::HeapSizeOf(variants) == variants.capacity() * sizeof(variant) + longHeap);
+    static_assert(!Reflection::detail::MayOwnHeap<std::variant<int, double>>);
+
+    // The owners of a std::shared_ptr share its memory evenly.
+    auto const shared = std::make_shared<std::string>(longText);
+    auto const alone = Reflection::HeapSizeOf(shared);
+    CHECK(alone >= sizeof(std::string) + longHeap);
+    auto const copy = shared;
+    CHECK(Reflection::HeapSizeOf(shared) == alone / 2);
+    CHECK(Reflection::HeapSizeOf(copy) == alone / 2);
+    CHECK(Reflection::HeapSizeOf(std::shared_ptr<int> {}) == 0);
+
+    // A std::unique_ptr counts its element_type, not the dynamic type of the object.
+    struct Base
+    {
+        virtual ~Base() = default;
+    };
+    struct Derived: Base
+    {
+        std::array<char, 64> payload {};
+    };
+    CHECK(Reflection::HeapSizeOf(std::unique_ptr<Base> { std::make_unique<Derived>() }) == sizeof(Base));
+}
+
+struct CompactRecord
+{
+    std::uint32_t id {};
+    std::int64_t delta {};
+    std::int8_t level {};
+    bool flag {};
+    Color color {};
+    double ratio {};
+    std::string name;
+    std::vector<std::int32_t> samples;
+};
+
+TEST_CASE("Binary.compact", "[reflection]")
+{
+    auto const original = CompactRecord { .id = 300,
+                                          .delta = -2,
+                                          .level = -128,
+                                          .flag = true,
+                                          .color = Color::Blue,
+                                          .ratio = 0.25,
+                                          .name = "abc",
+                                          .samples = { 0, -1, 1, 64 } };
+    std::vector<std::byte> buffer;
+    Reflection::SerializeCompact(original, buffer);
+    CHECK(buffer.size() == 2 + 1 + 2 + 1 + 1 + 8 + (1 + 3) + (1 + 1 + 1 + 1 + 2));
+    CHECK(buffer[0] == std::byte { 0xAC });
+    CHECK(buffer[1] == std::byte { 0x02 });
+    CHECK(buffer[2] == std::byte { 0x03 });
+
+    auto decoded = CompactRecord {};
+    CHECK(Reflection::DeserializeCompact(buffer, decoded));
+    CHECK(Reflection::Inspect(decoded) == Reflection::Inspect(original));
+
+    auto truncated = CompactRecord {};
+    CHECK_FALSE(Reflection::DeserializeCompact(std::span(buffer).first(buffer.size() - 1), truncated));
+
+    // Values out of the range of the member are rejected.
+    std::vector<std::byte> wide;
+    Reflection::SerializeCompact(std::uint64_t { 256 }, wide);
+    auto narrow = std::uint8_t {};
+    CHECK_FALSE(Reflection::DeserializeCompact(wide, narrow));
+
+    // Varints of every length, decoded with the fast path (followed by padding) and the byte by byte path.
+    for (auto const value: { std::uint64_t { 0 },
+                             std::uint64_t { 127 },
+                             std::uint64_t { 128 },
+                             std::uint64_t { 1 } << 49,
+                             (std::uint64_t { 1 } << 56) - 1,
+                             std::uint64_t { 1 } << 56,
+                             std::numeric_limits<std::uint64_t>::max() })
+    {
+        std::vector<std::byte> bytes;
+        Reflection::SerializeCompact(value, bytes);
+        auto const length = bytes.size();
+        bytes.resize(length + 8);
+        auto reader = Reflection::BinaryReader { bytes };
+        std::uint64_t fast {};
+        CHECK(reader.ReadVarint(fast));
+        CHECK(fast == value);
+        CHECK(reader.remaining() == 8);
+        auto exact = Reflection::BinaryReader { std::span(bytes).first(length) };
+        std::uint64_t slow {};
+        CHECK(exact.ReadVarint(slow));
+        CHECK(slow == value);
+    }
+
+    // A varint exceeding 64 bits is malformed.
+    auto overflow = std::vector<std::byte>(9, std::byte { 0xFF });
+    overflow.push_back(std::byte { 0x02 });
+    std::uint64_t ignored {};
+    CHECK_FALSE(Reflection::BinaryReader { overflow }.ReadVarint(ignored));
+}
+
+struct MsgPackRecord
+{
+    std::uint32_t id {};
+    std::int64_t delta {};
+    bool flag {};
+    Color color {};
+    double ratio {};
+    float weight {};
+    std::string name;
+    std::optional<std::string> comment;
+    std::vector<Record> records;
+};
+
+struct MsgPackRecordV2
+{
+    std::string name;
+    std::uint32_t id {};
+    std::string email = "none";
+};
+
+TEST_CASE("MsgPack", "[reflection]")
+{
+    auto const original = MsgPackRecord { .id = 300,
+                                          .delta = -40'000,
+                                          .flag = true,
+                                          .color = Color::Blue,
+                                          .ratio = 0.25,
+                                          .weight = 1.5f,
+                                          .name = "abc",
+                                          .comment = std::nullopt,
+                                          .records = { { .id = 1, .name = "John Doe", .age = 42 } } };
+
+    std::vector<std::byte> map;
+    Reflection::ToMsgPack(original, map);
+    // fixmap of 9 entries, then "id" as fixstr and 300 as uint16
+    CHECK(map[0] == std::byte { 0x89 });
+    CHECK(map[1] == std::byte { 0xA2 });
+    CHECK(map[2] == std::byte { 'i' });
+    CHECK(map[3] == std::byte { 'd' });
+    CHECK(map[4] == std::byte { 0xCD });
+    CHECK(map[5] == std::byte { 0x01 });
+    CHECK(map[6] == std::byte { 0x2C });
+
+    auto decoded = MsgPackRecord {};
+    decoded.comment = "replaced by nil";
+    CHECK(Reflection::FromMsgPack(map, decoded));
+    CHECK(Reflection::Inspect(decoded) == Reflection::Inspect(original));
+
+    std::vector<std::byte> array;
+    Reflection::ToMsgPack<Reflection::MsgPackLayout::Array>(original, array);
+    CHECK(array[0] == std::byte { 0x99 });
+    CHECK(array.size() < map.size());
+    auto fromArray = MsgPackRecord {};
+    CHECK(Reflection::FromMsgPack(array, fromArray));
+    CHECK(Reflection::Inspect(fromArray) == Reflection::Inspect(original));
+
+    // Maps are matched by name, skipping unknown entries, in any order.
+    auto other = MsgPackRecordV2 {};
+    CHECK(Reflection::FromMsgPack(map, other));
+    CHECK(other.name == "abc");
+    CHECK(other.id == 300);
+    CHECK(other.email == "none");
+
+    std::vector<std::byte> reordered;
+    Reflection::ToMsgPack(MsgPackRecordV2 { .name = "xyz", .id = 7, .email = "x@example.com" }, reordered);
+    auto older = MsgPackRecord {};
+    CHECK(Reflection::FromMsgPack(reordered, older));
+    CHECK(older.name == "xyz");
+    CHECK(older.id == 7);
+
+    // Values must fit into their members.
+    std::vector<std::byte> negative;
+    Reflection::ToMsgPack(std::int32_t { -1 }, negative);
+    auto unsignedValue = std::uint32_t {};
+    CHECK_FALSE(Reflection::FromMsgPack(negative, unsignedValue));
+    auto text = std::string {};
+    CHECK_FALSE(Reflection::FromMsgPack(negative, text));
+
+    auto truncated = MsgPackRecord {};
+    CHECK_FALSE(Reflection::FromMsgPack(std::span(map).first(map.size() - 1), truncated));
+}
+
+struct ChunkedBatch
+{
+    std::string name;
+    std::vector<BinaryRecord> records;
+    std::vector<int> counts;
+    Record last;
+};
+
+TEST_CASE("Binary.chunks", "[reflection]")
+{
+    auto batch = ChunkedBatch {};
+    batch.name = std::string(100, 'x');
+    batch.records.resize(3);
+    batch.records[1].name = "John Doe";
+    batch.records[1].tags = { "a", "bc", "" };
+    batch.records[2].nested.name = "Jane Doe";
+    batch.counts = { 1, 2, 3 };
+    batch.last = Record { .id = 1, .name = "Jane Doe", .age = 43 };
+
+    std::vector<std::byte> expected;
+    Reflection::SerializeBinary(batch, expected);
+
+    for (auto const chunkSize: std::vector<size_t> { 1, 3, 7, 64, expected.size(), 4096 })
+    {
+        std::vector<std::byte> joined;
+        std::vector<size_t> sizes;
+        for (auto const chunk: Reflection::SerializeChunks(batch, chunkSize))
+        {
+            joined.insert(joined.end(), chunk.begin(), chunk.end());
+            sizes.push_back(chunk.size());
+        }
+        CHECK(joined == expected);
+        REQUIRE(sizes.size() == (expected.size() + chunkSize - 1) / chunkSize);
+        CHECK(std::all_of(sizes.begin(), sizes.end() - 1, [&](size_t size) { return size == chunkSize; }));
+    }
+
+    // Stopping early releases the suspended coroutines.
+    auto chunks = Reflection::SerializeChunks(batch, 16);
+    auto it = chunks.begin();
+    CHECK(it != std::default_sentinel);
+    CHECK((*it).size() == 16);
+}
+
+struct GatherDocument
+{
+    std::uint64_t id {};
+    std::string title;
+    std::string body;
+    std::vector<std::uint8_t> blob;
+    std::vector<std::string> tags;
+    Record author;
+};
+
+namespace
+{
+
+int OpenForWriting(std::filesystem::path const& path)
+{
+#if defined(_WIN32)
+    return ::_wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+}
+
+void CloseFile(int fd)
+{
+#if defined(_WIN32)
+    ::_close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+template <typename T>
+concept GatherWritable =
+    requires(Reflection::GatherWriter& writer, T&& value) { writer.Write(std::forward<T>(value)); };
+
+// Temporaries would be destroyed before their members are written.
+static_assert(GatherWritable<GatherDocument&>);
+static_assert(GatherWritable<GatherDocument const&>);
+static_assert(!GatherWritable<GatherDocument>);
+
+TEST_CASE("GatherWriter", "[reflection]")
+{
+    auto documents = std::vector<GatherDocument>(3);
+    documents[0].title = "short";
+    documents[0].body = std::string(1000, 'b');
+    documents[0].blob = std::vector<std::uint8_t>(300, 7);
+    documents[0].tags = { "a", std::string(400, 't') };
+    documents[1].id = 1;
+    documents[2].id = 2;
+    documents[2].title = std::string(256, 'x');
+    documents[2].author = Record { .id = 1, .name = "Jane Doe", .age = 43 };
+
+    std::vector<std::byte> expected;
+    for (auto const& document: documents)
+        Reflection::SerializeBinary(document, expected);
+
+    auto const path = std::filesystem::temp_directory_path() / "reflection-cpp-test-gather.bin";
+    // A staging buffer smaller than some of the copied members forces intermediate flushes.
+    for (auto const stagingSize: { size_t { 16 }, Reflection::GatherWriter::DefaultStagingSize })
+    {
+        auto const fd = OpenForWriting(path);
+        REQUIRE(fd >= 0);
+        auto writer = Reflection::GatherWriter { fd, stagingSize };
+        for (auto const& document: documents)
+            CHECK(writer.Write(document));
+        CHECK(writer.Flush());
+        CHECK(writer.pending() == 0);
+        CHECK(writer.inPlaceBytes() == 1000 + 300 + 400 + 256);
+        CloseFile(fd);
+
+        auto written = std::vector<std::byte>(std::filesystem::file_size(path));
+        std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(written.data()),
+                                                   static_cast<std::streamsize>(written.size()));
+        CHECK(written == expected);
+    }
+    std::filesystem::remove(path);
+
+    auto failing = Reflection::GatherWriter { -1 };
+    CHECK(failing.Write(documents[0]));
+    CHECK_FALSE(failing.Flush());
+    CHECK_FALSE(failing.Write(documents[1]));
+}
+
+TEST_CASE("GatherWriter.bounded", "[reflection]")
+{
+    // Far more in-place members than fit into IOV_MAX segments or MaxPendingBytes, and no explicit Flush.
+    auto documents = std::vector<GatherDocument>(5000);
+    for (auto& document: documents)
+        document.body = std::string(300, 'b');
+
+    std::vector<std::byte> expected;
+    for (auto const& document: documents)
+        Reflection::SerializeBinary(document, expected);
+
+    auto const path = std::filesystem::temp_directory_path() / "reflection-cpp-test-gather-bounded.bin";
+    auto const fd = OpenForWriting(path);
+    REQUIRE(fd >= 0);
+    {
+        auto writer = Reflection::GatherWriter { fd };
+        auto good = true;
+        for (auto const& document: documents)
+            good = writer.Write(document) && good;
+        CHECK(good);
+        CHECK(writer.pending() > 0);
+        CHECK(writer.pending() < Reflection::GatherWriter::MaxPendingBytes);
+    } // flushes the rest
+    CloseFile(fd);
+
+    auto written = std::vector<std::byte>(std::filesystem::file_size(path));
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char*>(written.data()),
+                                               static_cast<std::streamsize>(written.size()));
+    CHECK(written == expected);
+    std::filesystem::remove(path);
+}
+
+struct SeqLockedQuote
+{
+    std::uint64_t sequence {};
+    double bid {};
+    double ask {};
+    std::int32_t size {};
+    std::array<std::uint32_t, 5> levels {};
+};
+
+namespace
+{
+
+SeqLockedQuote QuoteNumber(std::uint64_t n)
+{
+    auto quote = SeqLockedQuote { .sequence = n,
+                                  .bid = static_cast<double>(n),
+                                  .ask = static_cast<double>(n) + 1,
+                                  .size = static_cast<std::int32_t>(n % 1000) };
+    for (size_t i = 0; i < quote.levels.size(); ++i)
+        quote.levels[i] = static_cast<std::uint32_t>(n + i);
+    return quote;
+}
+
+bool IsQuoteNumber(SeqLockedQuote const& quote)
+{
+    auto differences = 0;
+    Reflection::CollectDifferences(quote, QuoteNumber(quote.sequence), [&](auto&&...) { ++differences; });
+    return differences == 0;
+}
+
+} // namespace
+
+TEST_CASE("SeqLocked", "[reflection]")
+{
+    auto quote = Reflection::SeqLocked<SeqLockedQuote> { QuoteNumber(1) };
+    CHECK(IsQuoteNumber(quote.load()));
+    quote.store(QuoteNumber(2));
+    CHECK(quote.load().sequence == 2);
+    CHECK(quote.load<&SeqLockedQuote::ask>() == 3.0);
+    CHECK(quote.load<&SeqLockedQuote::levels>()[4] == 6);
+
+    // Readers racing with the writer must never observe a mix of two stores.
+    constexpr std::uint64_t Stores = 200'000;
+    auto torn = std::atomic<size_t> { 0 };
+    auto regressed = std::atomic<size_t> { 0 };
+    auto done = std::atomic<bool> { false };
+    {
+        auto readers = std::vector<std::jthread> {};
+        for (int i = 0; i < 3; ++i)
+            readers.emplace_back([&] {
+                std::uint64_t last = 0;
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    auto const snapshot = quote.load();
+                    if (!IsQuoteNumber(snapshot))
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    auto const levels = quote.load<&SeqLockedQuote::levels>();
+                    if (levels[1] != levels[0] + 1 || levels[4] != levels[0] + 4)
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    if (snapshot.sequence < last)
+                        regressed.fetch_add(1, std::memory_order_relaxed);
+                    last = snapshot.sequence;
+                }
+            });
+        for (std::uint64_t n = 3; n < Stores; ++n)
+            quote.store(QuoteNumber(n));
+        done.store(true, std::memory_order_relaxed);
+    }
+    CHECK(torn.load() == 0);
+    CHECK(regressed.load() == 0);
+    CHECK(quote.load().sequence == Stores - 1);
+}